@@ -0,0 +1,228 @@
+// Bearer token verifications per request, before and after AuthMiddleware kept its result in
+// the request context. Every request makes the helper calls of a typical protected admin route
+// (is_authenticated, has_role, get_user_id):
+//
+//   before  the middleware verifies the token, then each helper verifies it again, as the
+//           helpers did when they re-read the Authorization header (reproduced below)
+//   after   AuthMiddleware::before_handle, then the same helpers reading its context
+//
+// Both are run with the verified-token cache off and at jwt.cacheSize. The middleware's check
+// that the user still exists is left out of "before"; in "after" it is answered from
+// UserStatusCache once warm, but it still needs the database in config.json and an existing
+// user id.
+//
+// Afterwards it checks that a revoked token is rejected with the cache off and on, both when
+// it is verified afresh and when it is answered from the cache, and exits with 1 if it is not.
+//
+//   cmake --build build --target bench_auth
+//   ./bench_auth [config.json] [--user N] [--requests N]
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <crow.h>
+#include "../include/config/Config.h"
+#include "../include/database/DBConnectionPool.h"
+#include "../include/middleware/AuthMiddleware.h"
+#include "../include/middleware/UserStatusCache.h"
+#include "../include/utils/JWTUtils.h"
+#include "../include/utils/TokenRevocationList.h"
+#include "../include/utils/Logger.h"
+
+namespace {
+    // The helpers as they were: each one verified the bearer token again
+    namespace before {
+        std::unordered_map<std::string, std::string> get_user_data(const crow::request& req) {
+            std::unordered_map<std::string, std::string> payload;
+            std::string authHeader = req.get_header_value("Authorization");
+
+            if (!authHeader.empty() && authHeader.substr(0, 7) == "Bearer ") {
+                JWTUtils::getInstance().verifyToken(authHeader.substr(7), payload);
+            }
+
+            return payload;
+        }
+
+        bool is_authenticated(const crow::request& req) {
+            std::string authHeader = req.get_header_value("Authorization");
+
+            if (authHeader.empty() || authHeader.substr(0, 7) != "Bearer ") {
+                return false;
+            }
+
+            std::unordered_map<std::string, std::string> payload;
+            return JWTUtils::getInstance().verifyToken(authHeader.substr(7), payload);
+        }
+
+        bool has_role(const crow::request& req, const std::vector<std::string>& roles) {
+            auto userData = get_user_data(req);
+            if (userData.empty() || userData.find("role") == userData.end()) {
+                return false;
+            }
+            return roles.empty() || std::find(roles.begin(), roles.end(), userData["role"]) != roles.end();
+        }
+
+        int get_user_id(const crow::request& req) {
+            auto userData = get_user_data(req);
+            if (userData.empty() || userData.find("id") == userData.end()) {
+                return 0;
+            }
+            return std::stoi(userData["id"]);
+        }
+
+        // The middleware's own verification
+        void before_handle(const crow::request& req) {
+            get_user_data(req);
+        }
+    }
+
+    // Stands in for crow::App: hands the helpers the context before_handle filled, as
+    // app.get_context does for a real request
+    struct BenchApp {
+        AuthMiddleware::context ctx;
+
+        template <typename Middleware>
+        typename Middleware::context& get_context(const crow::request&) { return ctx; }
+    };
+
+    uint64_t verifications() {
+        auto stats = JWTUtils::getInstance().getCacheStats();
+        return stats.hits + stats.misses;
+    }
+
+    struct Result {
+        double verificationsPerRequest;
+        double usPerRequest;
+    };
+
+    template <typename Request>
+    Result measure(int requests, Request&& handle) {
+        uint64_t verifiedBefore = verifications();
+        auto started = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < requests; ++i) {
+            handle();
+        }
+
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count();
+        return {static_cast<double>(verifications() - verifiedBefore) / requests, us / requests};
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string configFile = "config.json";
+    int userId = 1;
+    int requests = 20000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--user" && i + 1 < argc) {
+            userId = std::stoi(argv[++i]);
+        } else if (arg == "--requests" && i + 1 < argc) {
+            requests = std::stoi(argv[++i]);
+        } else {
+            configFile = arg;
+        }
+    }
+
+    Logger::getInstance()->init();
+
+    Config& config = Config::getInstance();
+    if (!config.load(configFile)) {
+        std::cerr << "Could not load " << configFile << std::endl;
+        return 1;
+    }
+
+    auto& pool = DBConnectionPool::getInstance();
+    pool.setMinPoolSize(config.getDbMinPool());
+    pool.setMaxPoolSize(config.getDbMaxPool());
+    if (!pool.initialize(config.getDbHost(), config.getDbUser(), config.getDbPassword(),
+                         config.getDbName(), config.getDbPort(), config.getDbPoolSize())) {
+        std::cerr << "Could not connect to " << config.getDbHost() << ":" << config.getDbPort() << std::endl;
+        return 1;
+    }
+    UserStatusCache::getInstance().setTtl(config.getJwtUserCacheTtlMs());
+
+    auto& jwt = JWTUtils::getInstance();
+    jwt.setSecret(config.getJwtSecret());
+    jwt.setExpiresIn(config.getJwtExpiresIn());
+
+    BenchApp app;
+    AuthMiddleware::bind(app);
+    AuthMiddleware middleware;
+
+    crow::request req;
+    req.add_header("Authorization", "Bearer " + jwt.generateToken(userId, "admin"));
+    req.middleware_context = &app.ctx;
+
+    crow::response res;
+    const std::vector<std::string> roles = {"admin"};
+
+    auto beforeRequest = [&] {
+        before::before_handle(req);
+        if (before::is_authenticated(req) && before::has_role(req, roles)) {
+            before::get_user_id(req);
+        }
+    };
+
+    auto afterRequest = [&] {
+        app.ctx = AuthMiddleware::context();
+        middleware.before_handle(req, res, app.ctx);
+        if (is_authenticated(req) && has_role(req, roles)) {
+            get_user_id(req);
+        }
+    };
+
+    // Warms UserStatusCache and tells whether the user exists
+    afterRequest();
+    if (!app.ctx.authenticated) {
+        std::cerr << "User " << userId << " does not exist; pass --user with an existing user id" << std::endl;
+        return 1;
+    }
+
+    std::cout << requests << " requests, user " << userId << "\n";
+    std::cout << std::setw(14) << "token cache" << std::setw(8) << "path"
+              << std::setw(18) << "verifications/req" << std::setw(10) << "us/req" << "\n";
+
+    for (size_t cacheSize : {size_t(0), static_cast<size_t>(std::max(0, config.getJwtCacheSize()))}) {
+        jwt.setCacheSize(cacheSize);
+        jwt.clearCache();
+
+        for (bool after : {false, true}) {
+            Result result = after ? measure(requests, afterRequest) : measure(requests, beforeRequest);
+
+            std::cout << std::setw(14) << (cacheSize > 0 ? std::to_string(cacheSize) : "off")
+                      << std::setw(8) << (after ? "after" : "before")
+                      << std::setw(18) << std::fixed << std::setprecision(2) << result.verificationsPerRequest
+                      << std::setw(10) << std::setprecision(1) << result.usPerRequest << "\n";
+        }
+    }
+
+    // Revoke a fresh token as logout does, then verify it twice under each cache setting: the
+    // first call misses the cache (and stores the result when it is on), the second hits it
+    std::unordered_map<std::string, std::string> claims;
+    std::string revokedToken = jwt.generateToken(userId, "admin");
+    jwt.verifyToken(revokedToken, claims);
+    TokenRevocationList::getInstance().revokeToken(
+        claims["jti"], std::chrono::system_clock::time_point(std::chrono::seconds(std::stoll(claims["exp"]))));
+
+    bool revocationHonoured = true;
+    for (size_t cacheSize : {size_t(0), static_cast<size_t>(std::max(0, config.getJwtCacheSize()))}) {
+        jwt.setCacheSize(cacheSize);
+        jwt.clearCache();
+
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            std::unordered_map<std::string, std::string> payload;
+            if (jwt.verifyToken(revokedToken, payload)) {
+                std::cerr << "Revoked token accepted with token cache "
+                          << (cacheSize > 0 ? std::to_string(cacheSize) : "off") << std::endl;
+                revocationHonoured = false;
+            }
+        }
+    }
+
+    pool.cleanup();
+    return revocationHonoured ? 0 : 1;
+}
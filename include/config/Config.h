@@ -1,8 +1,18 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+// Read replica connection settings; empty credentials fall back to the primary's
+struct DbReplicaConfig {
+    std::string host;
+    int port = 3306;
+    std::string user;
+    std::string password;
+    std::string name;
+};
+
 class Config {
 public:
     static Config& getInstance() {
@@ -20,8 +30,40 @@ public:
     std::string getDbName() const { return dbName; }
     int getDbPort() const { return dbPort; }
     int getDbPoolSize() const { return dbPoolSize; }
+    int getDbMinPool() const { return dbMinPool; }
+    int getDbMaxPool() const { return dbMaxPool; }
+    int getDbIdleTimeoutMs() const { return dbIdleTimeoutMs; }
+    int getDbAcquireTimeoutMs() const { return dbAcquireTimeoutMs; }
+    int getDbStatementCacheSize() const { return dbStatementCacheSize; }
+    int getDbWarmupQuorum() const { return dbWarmupQuorum; }
+    const std::vector<DbReplicaConfig>& getDbReplicas() const { return dbReplicas; }
+    std::string getDbReplicaSelection() const { return dbReplicaSelection; }
+    int getDbReadYourWritesMs() const { return dbReadYourWritesMs; }
+    int getDbExecutorThreads() const { return dbExecutorThreads; }
+    int getDbExecutorQueueSize() const { return dbExecutorQueueSize; }
+    int getDbSlowQueryMs() const { return dbSlowQueryMs; }
+    bool getDbThreadAffinity() const { return dbThreadAffinity; }
+    int getDbAffinityIdleMs() const { return dbAffinityIdleMs; }
+    int getDbHealthProbeMs() const { return dbHealthProbeMs; }
+    int getDbQueryCacheMb() const { return dbQueryCacheMb; }
+    int getDbQueryCacheTtlMs() const { return dbQueryCacheTtlMs; }
+    int getDbMaxWaiters() const { return dbMaxWaiters; }
+    std::string getDbQueuePolicy() const { return dbQueuePolicy; }
+    int getDbQueueTargetMs() const { return dbQueueTargetMs; }
+    int getDbQueueIntervalMs() const { return dbQueueIntervalMs; }
+    bool getDbAdaptiveLimit() const { return dbAdaptiveLimit; }
+    double getDbAdaptiveLimitTolerance() const { return dbAdaptiveLimitTolerance; }
+    int getDbCircuitFailureThreshold() const { return dbCircuitFailureThreshold; }
+    int getDbCircuitOpenMs() const { return dbCircuitOpenMs; }
     std::string getJwtSecret() const { return jwtSecret; }
     int getJwtExpiresIn() const { return jwtExpiresIn; }
+    int getJwtCacheSize() const { return jwtCacheSize; }
+    int getJwtUserCacheTtlMs() const { return jwtUserCacheTtlMs; }
+    int getJwtUserCacheSize() const { return jwtUserCacheSize; }
+    std::string getJwtRevocationFile() const { return jwtRevocationFile; }
+    int getPasswordIterations() const { return passwordIterations; }
+    int getPasswordHashThreads() const { return passwordHashThreads; }
+    int getPasswordHashQueueSize() const { return passwordHashQueueSize; }
 
 private:
     Config() = default;
@@ -41,6 +83,38 @@ private:
     std::string dbName = "airline_transportation";
     int dbPort = 3306;
     int dbPoolSize = 10;
+    int dbMinPool = 2;
+    int dbMaxPool = 20;
+    int dbIdleTimeoutMs = 60000;
+    int dbAcquireTimeoutMs = 5000;
+    int dbStatementCacheSize = 64;
+    int dbWarmupQuorum = 1;
+    std::vector<DbReplicaConfig> dbReplicas;
+    std::string dbReplicaSelection = "round-robin";
+    int dbReadYourWritesMs = 0;
+    int dbExecutorThreads = 8;
+    int dbExecutorQueueSize = 256;
+    int dbSlowQueryMs = 200;
+    bool dbThreadAffinity = false;
+    int dbAffinityIdleMs = 5000;
+    int dbHealthProbeMs = 1000;
+    int dbQueryCacheMb = 64;
+    int dbQueryCacheTtlMs = 30000;
+    int dbMaxWaiters = 64;
+    std::string dbQueuePolicy = "codel";
+    int dbQueueTargetMs = 50;
+    int dbQueueIntervalMs = 100;
+    bool dbAdaptiveLimit = true;
+    double dbAdaptiveLimitTolerance = 2.0;
+    int dbCircuitFailureThreshold = 5;
+    int dbCircuitOpenMs = 5000;
     std::string jwtSecret = "simpleSecretKey123";
     int jwtExpiresIn = 2592000; // 30 days in seconds
+    int jwtCacheSize = 10000;
+    int jwtUserCacheTtlMs = 5000;
+    int jwtUserCacheSize = 10000;
+    std::string jwtRevocationFile = "revoked_tokens.txt";
+    int passwordIterations = 600000;
+    int passwordHashThreads = 2;
+    int passwordHashQueueSize = 2;
 };
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <crow.h>
+#include <string>
+
+class AdminController {
+public:
+    // Per-statement execution statistics, most total time first
+    static crow::response getQueryStats(const crow::request& req);
+    static crow::response resetQueryStats(const crow::request& req);
+
+    // Query result cache counters and memory use; DELETE drops every entry
+    static crow::response getQueryCacheStats(const crow::request& req);
+    static crow::response clearQueryCache(const crow::request& req);
+
+    // Verified-token cache hit rate and the verification time it saved, plus the user-existence cache
+    static crow::response getTokenCacheStats(const crow::request& req);
+};
@@ -5,8 +5,11 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 #include "../utils/Logger.h"
+#include "../utils/JsonStreamWriter.h"
 #include "../database/DBConnectionPool.h"
+#include "../database/QueryCache.h"
 #include "../middleware/AuthMiddleware.h"
+#include "../middleware/LoadShedMiddleware.h"
 
 using json = nlohmann::json;
 
@@ -7,8 +7,10 @@
 #include <nlohmann/json.hpp>
 #include "../utils/Logger.h"
 #include "../utils/JWTUtils.h"
+#include "../utils/PasswordHasher.h"
 #include "../database/DBConnectionPool.h"
 #include "../middleware/AuthMiddleware.h"
+#include "../middleware/LoadShedMiddleware.h"
 
 // Use nlohmann::json explicitly
 using json = nlohmann::json;
@@ -19,9 +21,16 @@ public:
     static std::string hashPassword(const std::string& password);
     static bool verifyPassword(const std::string& providedPassword, const std::string& storedHash);
 
+    // Store a fresh hash after a login matched a legacy or weaker one, in the background
+    // when a hashing thread is idle
+    static void upgradePasswordHash(int userId, const std::string& password);
+
     // Helper for creating token responses
     static crow::response createTokenResponse(int userId, const std::string& role, const nlohmann::json& userData);
 
+    // 429 with Retry-After for when the password hashing queue is full
+    static crow::response createHasherBusyResponse(const PasswordHasherBusyError& e);
+
     // Auth endpoints
     static crow::response registerEmail(const crow::request& req);
     static crow::response registerPhone(const crow::request& req);
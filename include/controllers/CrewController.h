@@ -5,7 +5,9 @@
 #include <nlohmann/json.hpp>
 #include "../utils/Logger.h"
 #include "../database/DBConnectionPool.h"
+#include "../database/QueryCache.h"
 #include "../middleware/AuthMiddleware.h"
+#include "../middleware/LoadShedMiddleware.h"
 
 using json = nlohmann::json;
 
@@ -19,6 +21,7 @@ public:
     static crow::response deleteCrew(const crow::request& req);
     static crow::response getCrewMembers(const crow::request& req);
     static crow::response assignCrewMember(const crow::request& req);
+    static crow::response assignCrewMembersBulk(const crow::request& req);
     static crow::response removeCrewMember(const crow::request& req);
     static crow::response getCrewAircraft(const crow::request& req);
     static crow::response validateCrew(const crow::request& req);
@@ -5,8 +5,11 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 #include "../utils/Logger.h"
+#include "../utils/JsonStreamWriter.h"
 #include "../database/DBConnectionPool.h"
+#include "../database/DBExecutor.h"
 #include "../middleware/AuthMiddleware.h"
+#include "../middleware/LoadShedMiddleware.h"
 
 using json = nlohmann::json;
 
@@ -16,6 +19,7 @@ public:
     static crow::response getCrewMembers(const crow::request& req);
     static crow::response getCrewMember(const crow::request& req);
     static crow::response createCrewMember(const crow::request& req);
+    static crow::response createCrewMembersBulk(const crow::request& req);
     static crow::response updateCrewMember(const crow::request& req);
     static crow::response deleteCrewMember(const crow::request& req);
     static crow::response getCrewMemberAssignments(const crow::request& req);
@@ -6,7 +6,10 @@
 #include <nlohmann/json.hpp>
 #include "../utils/Logger.h"
 #include "../database/DBConnectionPool.h"
+#include "../database/QueryCache.h"
+#include "../database/DBExecutor.h"
 #include "../middleware/AuthMiddleware.h"
+#include "../middleware/LoadShedMiddleware.h"
 
 using json = nlohmann::json;
 
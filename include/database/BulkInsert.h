@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "QueryBatch.h"
+
+// Multi-row INSERT for many rows of one table. Rows are rendered as literals
+// (see SqlLiteral) and split into statements of at most maxStatementBytes, so
+// thousands of rows reach the server in a handful of round trips without
+// running into max_allowed_packet or the 65535 placeholder limit.
+class BulkInsert {
+public:
+    // Stays well below max_allowed_packet on any supported server (4 MiB on the oldest)
+    static constexpr size_t kDefaultMaxStatementBytes = 1024 * 1024;
+
+    BulkInsert(std::string table, std::vector<std::string> columns,
+               size_t maxStatementBytes = kDefaultMaxStatementBytes);
+
+    // Start a new row; the values bound after it fill the columns in order
+    BulkInsert& row();
+
+    BulkInsert& bind(int value);
+    BulkInsert& bind(long long value);
+    BulkInsert& bind(double value);
+    BulkInsert& bind(const std::string& value);
+    BulkInsert& bind(const char* value) { return bind(std::string(value)); }
+    BulkInsert& bindNull();
+
+    const std::string& getTable() const { return table; }
+    size_t size() const { return rows.size(); }
+    bool empty() const { return rows.empty(); }
+
+    // One INSERT statement and the rows it covers
+    struct Chunk {
+        std::string sql;
+        size_t firstRow;
+        size_t rowCount;
+    };
+
+    // Statements in row order; throws std::invalid_argument when a row has the wrong number of values.
+    // With singleRows every row gets its own statement, for servers that may not hand a multi-row
+    // INSERT consecutive auto-increment keys.
+    std::vector<Chunk> render(bool singleRows = false) const;
+
+private:
+    BulkInsert& bindLiteral(std::string literal);
+
+    std::string table;
+    std::vector<std::string> columns;
+    size_t maxStatementBytes;
+    std::vector<std::vector<std::string>> rows;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <cstdint>
+
+// Stops callers from piling up on a database that is down. Closed, every request goes
+// through; after failureThreshold consecutive failures it opens and requests fail at once.
+// Once the open period has passed it goes half-open and lets a single probe through:
+// success closes it, failure opens it for another period.
+class CircuitBreaker {
+public:
+    enum class State { Closed, Open, HalfOpen };
+
+    struct Stats {
+        State state;
+        int consecutiveFailures;
+        uint64_t opened;    // times the breaker has opened
+        uint64_t rejected;  // requests failed fast while open
+        long long retryInMs; // until the next probe is let through, 0 when closed
+    };
+
+    CircuitBreaker();
+
+    void setFailureThreshold(int failures) { this->failureThreshold = failures; }
+    void setOpenDuration(int durationMs) { this->openDuration = std::chrono::milliseconds(durationMs); }
+    int getFailureThreshold() const { return failureThreshold.load(); }
+    int getOpenDuration() const { return static_cast<int>(openDuration.count()); }
+
+    // Whether a request may go to the database now; in half-open state only the probe is let through
+    bool allowRequest();
+
+    // Same as allowRequest for background checks (health probe): a refusal is not counted as rejected
+    bool allowProbe();
+
+    // Whether allowRequest would let the next request through as the half-open probe, without
+    // taking it; used to route one request to a replica whose breaker is not closed
+    bool probeDue();
+
+    void recordSuccess();
+    void recordFailure(const std::string& reason);
+
+    bool isClosed() const { return state.load(std::memory_order_relaxed) == State::Closed; }
+
+    // Time until the breaker lets a probe through, for Retry-After
+    std::chrono::milliseconds retryIn();
+
+    Stats getStats();
+
+    static const char* stateName(State state);
+
+private:
+    bool admit();
+    void open(std::chrono::steady_clock::time_point now, const std::string& reason);
+
+    std::atomic<State> state;
+    std::atomic<int> consecutiveFailures;
+    std::atomic<int> failureThreshold;
+    std::chrono::milliseconds openDuration;
+
+    std::mutex mutex; // guards the transitions and the fields below; not taken while closed and healthy
+    std::chrono::steady_clock::time_point retryAt;
+    std::chrono::steady_clock::time_point probeStarted;
+    uint64_t opened;
+    std::atomic<uint64_t> rejected;
+};
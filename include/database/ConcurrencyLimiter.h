@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <cstdint>
+
+// AIMD limit on how many callers may hold a database connection at once, driven by how
+// long leases take. Each window the average lease time is compared with the lowest average
+// seen (the no-load baseline): well above it the database is queueing work internally, so
+// the limit backs off multiplicatively; otherwise, if the limit was actually in use, it
+// grows by one. The baseline drifts up slowly so a lasting change in the workload is
+// accepted as the new normal.
+class ConcurrencyLimiter {
+public:
+    struct Stats {
+        int limit;
+        double baselineMs;    // lowest window average lease time
+        double lastWindowMs;  // average lease time of the last window
+        uint64_t increases;
+        uint64_t decreases;
+    };
+
+    ConcurrencyLimiter();
+
+    // Limit range and starting point; resets the baseline
+    void configure(int minLimit, int maxLimit, int initialLimit);
+
+    // How far above the baseline (as a ratio) the window average may go before backing off
+    void setTolerance(double tolerance) { this->tolerance = tolerance; }
+    double getTolerance() const { return tolerance.load(); }
+
+    int getLimit() const { return limit.load(std::memory_order_relaxed); }
+
+    // One finished lease: how long it was held and how many leases were out at the time
+    void onSample(std::chrono::microseconds elapsed, int inflight);
+
+    Stats getStats();
+
+private:
+    // Close the window that just ended and adjust the limit; caller holds mutex
+    void evaluate(uint64_t count, uint64_t totalUs, int peakInflight);
+
+    static constexpr uint64_t kMinSamples = 10;
+    static constexpr double kBackoff = 0.9;
+    static constexpr double kBaselineDrift = 1.001; // per window; doubles in about three minutes
+    static constexpr std::chrono::milliseconds kWindow{250};
+
+    std::atomic<int> limit;
+    std::atomic<int> minLimit;
+    std::atomic<int> maxLimit;
+    std::atomic<double> tolerance;
+
+    // Current window, accumulated without a lock
+    std::atomic<uint64_t> sampleCount;
+    std::atomic<uint64_t> sampleTotalUs;
+    std::atomic<int> peakInflight;
+    std::atomic<int64_t> windowEnd; // steady_clock ticks
+
+    std::mutex mutex; // guards the fields below; only taken once per window
+    double baselineUs;
+    double lastWindowUs;
+    uint64_t increases;
+    uint64_t decreases;
+};
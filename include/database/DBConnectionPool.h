@@ -2,13 +2,28 @@
 
 #include <string>
 #include <vector>
+#include <list>
+#include <deque>
+#include <unordered_map>
 #include <mutex>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 #include <mariadb/conncpp.hpp>
+#include "QueryBatch.h"
+#include "BulkInsert.h"
+#include "Transaction.h"
+#include "QueryStats.h"
+#include "PoolSaturatedError.h"
+#include "ConcurrencyLimiter.h"
+#include "CircuitBreaker.h"
 
 class DBConnection {
 public:
-    DBConnection(std::shared_ptr<sql::Connection> conn);
+    DBConnection(std::shared_ptr<sql::Connection> conn, size_t statementCacheSize = 64,
+                 std::shared_ptr<CircuitBreaker> breaker = nullptr);
     ~DBConnection();
 
     // Get raw connection
@@ -16,14 +31,150 @@ public:
 
     // Query execution helpers
     std::unique_ptr<sql::ResultSet> executeQuery(const std::string& query);
-    std::unique_ptr<sql::ResultSet> executeQuery(std::unique_ptr<sql::PreparedStatement>& stmt);
+    std::unique_ptr<sql::ResultSet> executeQuery(const std::shared_ptr<sql::PreparedStatement>& stmt);
     int executeUpdate(const std::string& query);
-    int executeUpdate(std::unique_ptr<sql::PreparedStatement>& stmt);
-    std::unique_ptr<sql::PreparedStatement> prepareStatement(const std::string& query);
+    int executeUpdate(const std::shared_ptr<sql::PreparedStatement>& stmt);
+
+    // Send every statement of the batch in one round trip; read the results in order from the returned BatchResult
+    BatchResult executeBatch(const QueryBatch& batch);
+
+    // Run a multi-row insert one chunk per round trip; wrap it in a transaction for all-or-nothing.
+    // Returns the generated key of every row in row order (0 for tables without an auto-increment key)
+    std::vector<int64_t> executeBulkInsert(const BulkInsert& insert);
+
+    // Start a transaction on this connection; it rolls back unless committed
+    Transaction beginTransaction(IsolationLevel isolation = IsolationLevel::Default);
+
+    // Returns a prepared statement for the query from this connection's LRU cache,
+    // preparing it on a miss. The statement's parameters are cleared before it is returned.
+    std::shared_ptr<sql::PreparedStatement> prepareStatement(const std::string& query);
+
+    // Prepare an INSERT whose auto-increment key can be read back by executeInsert; cached like prepareStatement
+    std::shared_ptr<sql::PreparedStatement> prepareInsert(const std::string& query);
+
+    // Execute an INSERT from prepareInsert and return the generated key from the same round trip (0 if none)
+    int64_t executeInsert(const std::shared_ptr<sql::PreparedStatement>& stmt);
+
+    // Prepared statement cache statistics
+    uint64_t getStatementCacheHits() const { return statementCacheHits.load(std::memory_order_relaxed); }
+    uint64_t getStatementCacheMisses() const { return statementCacheMisses.load(std::memory_order_relaxed); }
+    size_t getStatementCacheSize() const { return statementCache.size(); }
+
+    // Drop all cached statements (e.g. after the session was reset)
+    void clearStatementCache();
+
+    // Round-trip to the server to check the connection is still usable
+    bool ping();
+
+    // Whether the last transaction could not be ended; the pool discards such a connection
+    // rather than hand its open transaction and locks to the next caller
+    bool transactionFailed() const { return transactionState && transactionState->failed; }
 
 private:
+    std::shared_ptr<sql::PreparedStatement> prepareCached(const std::string& query, bool generatedKeys);
+
+    // Whether a multi-row INSERT on this session gets consecutive auto-increment keys, so the ones
+    // the driver does not list can be derived from the last; asked from the server once per connection
+    bool consecutiveInsertKeys();
+
+    // Timing of statements prepared through this connection, for QueryStats
+    struct StatementInfo {
+        QueryStats::Entry* stats;
+        int parameterCount;
+        std::vector<std::string> writes; // tables to invalidate in QueryCache after it runs
+    };
+    using StatementInfoMap = std::unordered_map<const sql::PreparedStatement*, StatementInfo>;
+
+    const StatementInfo* infoFor(const sql::PreparedStatement* stmt) const;
+    static void recordExecution(const StatementInfo* info, std::chrono::steady_clock::time_point started, uint64_t rows);
+    static uint64_t rowCount(const sql::ResultSet* result);
+
+    // Tables written by an open beginTransaction(), invalidated again when it ends
+    struct TransactionState {
+        bool open = true;
+        bool failed = false; // COMMIT or ROLLBACK failed, so the transaction may still be open on the server
+        std::vector<std::string> tables;
+    };
+
+    // Drop cached results for tables a statement just wrote
+    void invalidateWrites(const std::vector<std::string>& tables);
+
+    // Feed the pool's circuit breaker; only errors meaning the server could not be reached count
+    void recordSuccess() const {
+        if (breaker) {
+            breaker->recordSuccess();
+        }
+    }
+    void recordFailure(const sql::SQLException& e) const;
+
+    using StatementCacheEntry = std::pair<std::string, std::shared_ptr<sql::PreparedStatement>>;
+
     std::shared_ptr<sql::Connection> connection;
-    bool inUse;
+    std::shared_ptr<CircuitBreaker> breaker;
+
+    // Most recently used statements at the front
+    std::list<StatementCacheEntry> statementCache;
+    std::unordered_map<std::string, std::list<StatementCacheEntry>::iterator> statementCacheIndex;
+    size_t statementCacheCapacity;
+    std::atomic<uint64_t> statementCacheHits;
+    std::atomic<uint64_t> statementCacheMisses;
+
+    // Shared with each statement's deleter, which removes the statement's entry when it is freed
+    std::shared_ptr<StatementInfoMap> statementInfo;
+
+    std::shared_ptr<TransactionState> transactionState;
+
+    enum class KeyOrder { Unknown, Consecutive, Unordered };
+    KeyOrder insertKeyOrder = KeyOrder::Unknown;
+
+    // Maintained by the pool under the owning free-list shard's lock
+    std::chrono::steady_clock::time_point lastUsed;
+    std::chrono::steady_clock::time_point lastChecked;
+
+    friend class DBConnectionPool;
+};
+
+class DBConnectionPool;
+
+// Connection a worker thread keeps between requests in thread-affine mode
+struct AffineSlot {
+    std::mutex mutex; // uncontended except when the pool reclaims the connection
+    const DBConnectionPool* owner = nullptr;
+    DBConnectionPool* pool = nullptr; // cleared once the pool or the thread is gone
+    std::shared_ptr<DBConnection> conn;
+    bool inUse = false;
+};
+
+// Move-only handle to a pooled connection; returns it to the pool when destroyed
+class ConnectionLease {
+public:
+    ConnectionLease() = default;
+    ConnectionLease(DBConnectionPool* pool, std::shared_ptr<DBConnection> conn,
+                    std::shared_ptr<AffineSlot> slot = nullptr);
+    ~ConnectionLease();
+
+    ConnectionLease(ConnectionLease&& other) noexcept;
+    ConnectionLease& operator=(ConnectionLease&& other) noexcept;
+    ConnectionLease(const ConnectionLease&) = delete;
+    ConnectionLease& operator=(const ConnectionLease&) = delete;
+
+    DBConnection* operator->() const { return conn.get(); }
+    DBConnection& operator*() const { return *conn; }
+    explicit operator bool() const { return conn != nullptr; }
+
+    // Give the connection back before the lease goes out of scope
+    void release();
+
+    // True when the connection is the primary's, so what it reads is current rather than as of
+    // a replica that may lag behind
+    bool isPrimary() const;
+
+private:
+    DBConnectionPool* pool = nullptr;
+    std::shared_ptr<DBConnection> conn;
+    int writerId = 0; // user whose write this lease carries, for read-your-writes routing
+    std::chrono::steady_clock::time_point acquiredAt; // for the pool's adaptive concurrency limit
+    std::shared_ptr<AffineSlot> slot; // set when the connection stays with this thread after release
 
     friend class DBConnectionPool;
 };
@@ -45,11 +196,107 @@ public:
         int poolSize = 10
     );
 
-    // Get a database connection from the pool
-    std::shared_ptr<DBConnection> getConnection();
+    // Get a database connection from the pool, waiting up to the acquire timeout
+    // when all connections are busy and the pool is at its maximum size.
+    // Throws PoolSaturatedError when the wait queue is full or the wait times out.
+    ConnectionLease getConnection();
+
+    // Read/write routing. Writes always go to the primary; reads go to a replica
+    // unless none is available or the user wrote within the read-your-writes window.
+    // ConnectionLease::isPrimary tells which one a read lease came from.
+    ConnectionLease getWriteConnection(int userId = 0);
+    ConnectionLease getReadConnection(int userId = 0);
+
+    // Open a replica pool with the same limits as the primary (call after initialize)
+    bool addReplica(
+        const std::string& host,
+        const std::string& user,
+        const std::string& password,
+        const std::string& database,
+        int port = 3306,
+        int poolSize = 10
+    );
+
+    // "round-robin" (default) or "least-loaded"
+    void setReplicaSelection(const std::string& strategy) { this->leastLoadedReplicas = (strategy == "least-loaded"); }
+    // Send a user's reads to the primary for this long after they write; 0 disables
+    void setReadYourWritesWindow(int windowMs) { this->readYourWritesWindow = std::chrono::milliseconds(windowMs); }
+
+    // Pool limits (call before initialize)
+    void setMaxPoolSize(int maxPoolSize) { this->maxPoolSize = maxPoolSize; }
+    void setAcquireTimeout(int timeoutMs) { this->acquireTimeout = std::chrono::milliseconds(timeoutMs); }
+    void setStatementCacheSize(int size) { this->statementCacheSize = size; }
+    void setMinPoolSize(int minPoolSize) { this->minPoolSize = minPoolSize; }
+    void setWarmupQuorum(int quorum) { this->warmupQuorum = quorum; }
+    void setIdleTimeout(int timeoutMs) { this->idleTimeout = std::chrono::milliseconds(timeoutMs); }
+
+    // Wait queue for callers that find the pool exhausted. Beyond maxWaiters callers are
+    // rejected at once (0 = unbounded). Policy is "fifo", "lifo" or "codel": CoDel serves
+    // the queue in order until it has not drained for a whole interval, then serves the
+    // newest waiter first and gives new waiters only the target delay, so a backlog is
+    // shed quickly instead of making every request late.
+    void setMaxWaiters(int maxWaiters) { this->maxWaiters = maxWaiters; }
+    void setQueuePolicy(const std::string& policy);
+    void setQueueTarget(int targetMs) { this->queueTarget = std::chrono::milliseconds(targetMs); }
+    void setQueueInterval(int intervalMs) { this->queueInterval = std::chrono::milliseconds(intervalMs); }
 
-    // Check database health
+    // Adaptive concurrency limit: how many leases may be out at once moves between minPoolSize and
+    // maxPoolSize (starting at the initial pool size) with measured lease times, and the pool only
+    // grows up to it. Callers over the limit wait in the queue. Re-using a connection parked on
+    // a thread in thread-affine mode is not limited. Call before initialize.
+    void setAdaptiveLimit(bool enabled) { this->adaptiveLimit = enabled; }
+    void setAdaptiveLimitTolerance(double tolerance) { limiter.setTolerance(tolerance); }
+    ConcurrencyLimiter::Stats getLimiterStats() { return limiter.getStats(); }
+
+    // Circuit breaker around connection creation and queries: after failureThreshold consecutive
+    // connection-level failures, checkouts fail with PoolSaturatedError (CircuitOpen) for openMs,
+    // then one probe request is let through to test the database again
+    void setCircuitBreaker(int failureThreshold, int openMs) {
+        breaker->setFailureThreshold(failureThreshold);
+        breaker->setOpenDuration(openMs);
+    }
+    CircuitBreaker::Stats getCircuitStats() { return breaker->getStats(); }
+
+    // True when new callers would be rejected: the wait queue of the primary and of every replica is full
+    bool isSaturated() const;
+    // Suggested client back-off when rejecting work, from the acquire timeout
+    int getRetryAfterSeconds() const;
+    // Thread-affine mode: each thread keeps the connection it last used instead of returning it,
+    // so its statement cache stays warm and checkout takes no shared lock. A thread gives the
+    // connection back after the affinity idle timeout, when it exits, or on cleanup.
+    void setThreadAffinity(bool enabled) { this->threadAffinity = enabled; }
+    void setAffinityIdleTimeout(int timeoutMs) { this->affinityIdleTimeout = std::chrono::milliseconds(timeoutMs); }
+
+    // Result of the last background health probe; reading it never touches the database
+    struct HealthStatus {
+        bool healthy = false;
+        bool stale = true;          // no probe result within the health TTL
+        long long ageMs = -1;       // time since the last probe finished, -1 before the first one
+        long long latencyUs = 0;    // round trip of the last successful probe
+        int consecutiveFailures = 0;
+        std::string lastError;
+    };
+
+    // Saturation figures, cheap enough to read on every health request
+    struct PoolStats {
+        int size = 0;       // open connections
+        int maxSize = 0;
+        int leased = 0;     // checked out right now
+        int idle = 0;       // open and not checked out (includes connections parked on threads)
+        int waiters = 0;    // callers blocked waiting for a connection
+        int pending = 0;    // connections being opened
+        long long shed = 0; // callers rejected since startup because the queue was full or their wait timed out
+        int limit = 0;      // concurrent leases allowed right now (maxSize unless the limit is adaptive)
+    };
+
+    // Check database health from the cached probe status
     bool checkHealth();
+    HealthStatus getHealthStatus();
+    PoolStats getStats();
+
+    // Probe the database on a dedicated connection every intervalMs (call before initialize);
+    // results older than three intervals count as unhealthy
+    void setHealthProbeInterval(int intervalMs) { this->healthProbeInterval = std::chrono::milliseconds(intervalMs); }
 
     // Close all connections and clean up
     void cleanup();
@@ -64,17 +311,160 @@ private:
     DBConnectionPool(DBConnectionPool&&) = delete;
     DBConnectionPool& operator=(DBConnectionPool&&) = delete;
 
-    // Create a new database connection
+    // Create a new database connection; nullptr when the connect fails. The outcome is not
+    // reported to the circuit breaker here: each caller decides whether it may count
     std::shared_ptr<sql::Connection> createConnection();
 
+    // Return a leased connection to the pool and wake one waiter
+    void releaseConnection(const std::shared_ptr<DBConnection>& conn);
+
+    // Roll back a transaction left open on a returned connection; false if the connection was dropped
+    bool resetSession(const std::shared_ptr<DBConnection>& conn);
+
+    // Checkout through the shared free-lists, bypassing thread affinity
+    ConnectionLease acquireShared();
+
+    // Thread-affine mode: this thread's slot for this pool, and handing a connection back to it
+    std::shared_ptr<AffineSlot> affineSlot();
+    void parkAffine(const std::shared_ptr<AffineSlot>& slot, const std::shared_ptr<DBConnection>& conn);
+    void reclaimAffine(std::chrono::steady_clock::time_point now);
+    void releaseAffineSlots();
+
+    // Idle connections are kept in per-thread-group stacks so that checkout and
+    // return only touch one small lock; callers steal from other shards when theirs is empty
+    struct alignas(64) FreeListShard {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<DBConnection>> idle;
+    };
+
+    size_t homeShard() const;
+    std::shared_ptr<DBConnection> tryAcquireIdle(bool blocking);
+    void pushIdle(std::shared_ptr<DBConnection> conn);
+    ConnectionLease acquireSlow();
+
+    // Callers blocked in acquireSlow, each woken individually in queue-policy order
+    enum class QueuePolicy { Fifo, Lifo, CoDel };
+
+    struct Waiter {
+        std::condition_variable cv;
+        bool signalled = false;
+    };
+
+    // Hand up to count freed connections (or growth slots) to waiters; caller holds mutex
+    void wakeWaiters(size_t count = 1);
+    void wakeAllWaiters();
+    bool queueOverloaded(std::chrono::steady_clock::time_point now) const;
+
+    // Leases allowed right now, and whether one more fits
+    int currentLimit() const;
+    bool underLimit() const { return leasedConnections.load() < currentLimit(); }
+    void recordLeaseTime(std::chrono::steady_clock::time_point acquiredAt, int inflight);
+
+    // Progress of the concurrent warm-up started by initialize
+    struct WarmupState {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::chrono::steady_clock::time_point started;
+        int target = 0;
+        int connected = 0;
+        int failed = 0;
+        long long fastestMs = 0;
+        long long slowestMs = 0;
+    };
+
+    void warmupConnection(std::shared_ptr<WarmupState> state);
+    void joinWarmupThreads();
+
+    // Background maintenance: keepalive pings, broken connection replacement,
+    // idle shrinking down to minPoolSize and pre-growing when callers had to wait
+    void startMaintenance();
+    void stopMaintenanceThread();
+    void maintenanceLoop();
+    void runMaintenance();
+    bool addIdleConnection();
+    bool retireConnection(const std::shared_ptr<DBConnection>& conn, bool keepMinimum);
+
+    // Health prober: runs SELECT 1 on its own connection, outside the pool's limits,
+    // so probes never compete with requests for a slot
+    void startHealthProbe();
+    void stopHealthProbeThread();
+    void healthProbeLoop();
+    void runHealthProbe(std::shared_ptr<sql::Connection>& probeConnection);
+
+    // Replica selection and read-your-writes bookkeeping
+    DBConnectionPool* pickReplica();
+    void recordWrite(int userId);
+    bool wroteRecently(int userId);
+
     std::shared_ptr<sql::Driver> driver;
+    std::vector<std::unique_ptr<FreeListShard>> shards;
+
+    // All open connections; guarded by mutex, which is only taken to grow, wait or clean up
     std::vector<std::shared_ptr<DBConnection>> connections;
     std::mutex mutex;
+    std::atomic<int> waiters;
+
+    std::deque<Waiter*> waitQueue; // guarded by mutex; oldest at the front
+    std::chrono::steady_clock::time_point queueLastEmpty;
+    std::atomic<int> maxWaiters;
+    QueuePolicy queuePolicy;
+    std::chrono::milliseconds queueTarget;
+    std::chrono::milliseconds queueInterval;
+    std::atomic<long long> shedCount;
+
+    std::atomic<bool> adaptiveLimit;
+    ConcurrencyLimiter limiter;
+
+    // Shared with the pool's connections, which report query outcomes to it
+    std::shared_ptr<CircuitBreaker> breaker;
+
+    int maxPoolSize;
+    std::chrono::milliseconds acquireTimeout;
+    int pendingConnections; // slots reserved by callers currently opening a connection
+    int statementCacheSize;
+    int warmupQuorum;
+    std::vector<std::thread> warmupThreads;
+    int minPoolSize;
+    std::chrono::milliseconds idleTimeout;
+    std::chrono::milliseconds keepaliveInterval;
+    std::chrono::milliseconds maintenanceInterval;
+    std::atomic<int> recentWaits; // callers that blocked since the last maintenance run
+
+    std::thread healthThread;
+    std::mutex healthMutex; // guards healthStatus, lastProbe and stopHealthProbe
+    std::condition_variable healthCv;
+    bool stopHealthProbe;
+    std::chrono::milliseconds healthProbeInterval;
+    HealthStatus healthStatus;
+    std::chrono::steady_clock::time_point lastProbe;
+
+    std::thread maintenanceThread;
+    std::mutex maintenanceMutex;
+    std::condition_variable maintenanceCv;
+    bool stopMaintenance;
 
     std::string host;
     std::string user;
     std::string password;
     std::string database;
     int port;
-    bool initialized;
+    std::atomic<bool> initialized;
+
+    // Replica pools; only modified during startup, before requests are served
+    std::vector<std::unique_ptr<DBConnectionPool>> replicas;
+    std::atomic<size_t> nextReplica;
+    bool leastLoadedReplicas;
+    std::atomic<int> leasedConnections; // connections currently checked out of this pool
+    std::chrono::milliseconds readYourWritesWindow;
+    std::mutex recentWritersMutex;
+    std::unordered_map<int, std::chrono::steady_clock::time_point> recentWriters;
+
+    // Thread-affine mode; slots of every thread that has used this pool, for reclaiming idle connections
+    std::atomic<bool> threadAffinity;
+    std::chrono::milliseconds affinityIdleTimeout;
+    std::mutex affineMutex;
+    std::vector<std::shared_ptr<AffineSlot>> affineSlots;
+
+    friend class ConnectionLease;
+    friend struct std::default_delete<DBConnectionPool>;
 };
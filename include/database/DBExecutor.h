@@ -0,0 +1,76 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include "PoolSaturatedError.h"
+
+// Runs blocking database work on a fixed set of threads so the number of
+// in-flight queries is capped independently of the HTTP worker count
+class DBExecutor {
+public:
+    static DBExecutor& getInstance() {
+        static DBExecutor instance;
+        return instance;
+    }
+
+    // Start the worker threads; maxQueued bounds the work waiting for a free thread
+    void start(int threads, int maxQueued = 256);
+
+    // Finish queued work and join the worker threads
+    void stop();
+
+    // Queue fn and return a future for its result; exceptions thrown by fn are
+    // rethrown from future.get(). Runs fn inline when the executor is not started.
+    // Throws PoolSaturatedError when the queue is full.
+    // Do not wait on a future from inside a task: that can starve the workers.
+    template<typename F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+        auto future = task->get_future();
+
+        if (!enqueue([task]() { (*task)(); })) {
+            (*task)();
+        }
+
+        return future;
+    }
+
+    // Statistics
+    int getThreadCount() const { return static_cast<int>(workers.size()); }
+    int getQueuedCount() const { return queued; }
+    int getActiveCount() const { return active; }
+
+private:
+    DBExecutor() : maxQueued(256), running(false), queued(0), active(0) {}
+    ~DBExecutor();
+
+    // Disable copy and move
+    DBExecutor(const DBExecutor&) = delete;
+    DBExecutor& operator=(const DBExecutor&) = delete;
+    DBExecutor(DBExecutor&&) = delete;
+    DBExecutor& operator=(DBExecutor&&) = delete;
+
+    // Returns false when the executor is not running
+    bool enqueue(std::function<void()> job);
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    size_t maxQueued;
+    bool running;
+
+    std::atomic<int> queued;
+    std::atomic<int> active;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+// Thrown when database work is turned away because the pool or the executor is saturated,
+// or because the circuit breaker has the database marked as down. Unlike other errors it
+// is expected: callers answer 503 with Retry-After instead of logging a failure.
+class PoolSaturatedError : public std::runtime_error {
+public:
+    enum class Reason {
+        QueueFull,  // too many callers were already waiting
+        Timeout,    // no connection came free before the caller's deadline
+        CircuitOpen // recent attempts failed; the database is not tried again until the breaker lets a probe through
+    };
+
+    PoolSaturatedError(Reason reason, const std::string& message, int retryAfterSeconds = 1)
+        : std::runtime_error(message), reason(reason), retryAfterSeconds(retryAfterSeconds) {}
+
+    Reason getReason() const { return reason; }
+    int getRetryAfterSeconds() const { return retryAfterSeconds; }
+
+private:
+    Reason reason;
+    int retryAfterSeconds;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mariadb/conncpp.hpp>
+
+// SQL literal text for a bound value: numbers as-is, strings as hex literals,
+// which cannot break out of their quoting whatever the SQL mode
+namespace SqlLiteral {
+    std::string of(long long value);
+    std::string of(double value);
+    std::string of(const std::string& value);
+}
+
+// Several statements sent to the server in a single round trip.
+// Server-side prepared statements cannot span statements, so parameters are
+// bound by type and rendered as literals (see SqlLiteral).
+class QueryBatch {
+public:
+    // Append a statement; its ? placeholders take the values bound after it
+    QueryBatch& add(const std::string& query);
+
+    QueryBatch& bind(int value);
+    QueryBatch& bind(long long value);
+    QueryBatch& bind(double value);
+    QueryBatch& bind(const std::string& value);
+    QueryBatch& bind(const char* value) { return bind(std::string(value)); }
+    QueryBatch& bindNull();
+
+    size_t size() const { return statements.size(); }
+
+    // Multi-statement SQL text; throws std::invalid_argument when placeholders and bound values do not match
+    std::string render() const;
+
+private:
+    struct Statement {
+        std::string query;
+        std::vector<std::string> literals;
+    };
+
+    QueryBatch& bindLiteral(std::string literal);
+
+    std::vector<Statement> statements;
+};
+
+// Sequential access to the result sets produced by a batch. Each call to next()
+// invalidates the previous result set; unread results are drained on destruction
+// so the connection can be reused.
+class BatchResult {
+public:
+    BatchResult(std::unique_ptr<sql::Statement> statement, bool hasResultSet);
+    ~BatchResult();
+
+    BatchResult(BatchResult&&) = default;
+    BatchResult& operator=(BatchResult&&) = delete;
+    BatchResult(const BatchResult&) = delete;
+    BatchResult& operator=(const BatchResult&) = delete;
+
+    // Result set of the next statement that returned rows, owned by the batch;
+    // throws std::runtime_error when there are none left
+    sql::ResultSet* next();
+
+private:
+    // Move the statement to its next result set, skipping update counts
+    bool advance();
+
+    std::unique_ptr<sql::Statement> statement;
+    std::unique_ptr<sql::ResultSet> current;
+    bool pending; // the statement is positioned on a result set that has not been handed out yet
+};
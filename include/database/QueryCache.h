@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <array>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Results of read queries, keyed by the statement text with its bound values and
+// tagged with the tables the query reads. Writes made through DBConnection bump the
+// version of every table they touch, which makes entries tagged with it stale; the
+// TTL bounds staleness from writers the process cannot see (other instances, replicas).
+class QueryCache {
+public:
+    static QueryCache& getInstance() {
+        static QueryCache instance;
+        return instance;
+    }
+
+    // Result of lookup(): the cached value on a hit, otherwise what store() needs
+    class Lookup {
+    public:
+        explicit operator bool() const { return value != nullptr; }
+        const std::string& operator*() const { return *value; }
+
+    private:
+        friend class QueryCache;
+
+        std::string key;
+        std::vector<std::string> tables;
+        std::vector<uint64_t> versions; // table versions when the lookup missed
+        std::shared_ptr<const std::string> value;
+        bool enabled = false;
+    };
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t stale;         // entries dropped on lookup because they expired or a table changed
+        uint64_t evictions;     // entries dropped to stay within the memory limit
+        uint64_t invalidations; // table writes seen
+        uint64_t entries;
+        uint64_t bytes;
+        uint64_t maxBytes;
+    };
+
+    // key is the statement with its bound values, e.g. QueryBatch::render()
+    Lookup lookup(const std::string& key, const std::vector<std::string>& tables);
+
+    // Fill the entry a lookup missed; skipped when one of its tables was written in the meantime,
+    // since the value may predate that write
+    void store(const Lookup& miss, std::string value);
+
+    // Mark tables as written; entries tagged with any of them are no longer served
+    void invalidate(const std::vector<std::string>& tables);
+
+    // Tables a write statement (INSERT, UPDATE, DELETE, ...) touches; empty for reads
+    static std::vector<std::string> tablesWritten(const std::string& sql);
+
+    // 0 disables the cache (call before serving requests)
+    void setMaxBytes(size_t maxBytes) { this->maxBytes = maxBytes; }
+    void setTtl(int ttlMs) { this->ttl = std::chrono::milliseconds(ttlMs); }
+
+    Stats getStats();
+    void clear();
+
+private:
+    QueryCache() : maxBytes(64 * 1024 * 1024), ttl(30000), hits(0), misses(0), stale(0), evictions(0), invalidations(0) {}
+
+    // Disable copy and move
+    QueryCache(const QueryCache&) = delete;
+    QueryCache& operator=(const QueryCache&) = delete;
+    QueryCache(QueryCache&&) = delete;
+    QueryCache& operator=(QueryCache&&) = delete;
+
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const std::string> value;
+        std::vector<std::string> tables;
+        std::vector<uint64_t> versions;
+        std::chrono::steady_clock::time_point expires;
+        size_t bytes;
+    };
+
+    // Each shard is an LRU list with its share of the memory limit
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::list<Entry> entries; // most recently used at the front
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+    };
+
+    static constexpr size_t kShards = 16;
+
+    Shard& shardFor(const std::string& key);
+    std::vector<uint64_t> currentVersions(const std::vector<std::string>& tables);
+    void erase(Shard& shard, std::list<Entry>::iterator it);
+
+    std::array<Shard, kShards> shards;
+
+    std::shared_mutex versionsMutex;
+    std::unordered_map<std::string, uint64_t> versions; // write count per table
+
+    std::atomic<size_t> maxBytes;
+    std::chrono::milliseconds ttl;
+
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> stale;
+    std::atomic<uint64_t> evictions;
+    std::atomic<uint64_t> invalidations;
+};
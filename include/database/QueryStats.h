@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Execution statistics aggregated by statement fingerprint, shared by all connections
+class QueryStats {
+public:
+    static QueryStats& getInstance() {
+        static QueryStats instance;
+        return instance;
+    }
+
+    // Log-scale latency histogram: four buckets per power of two of microseconds
+    static constexpr size_t kHistogramBuckets = 4 * 32;
+
+    // Counters for one fingerprint; entries are never freed, so callers may keep the pointer
+    struct Entry {
+        std::string fingerprint;
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> totalUs{0};
+        std::atomic<uint64_t> maxUs{0};
+        std::atomic<uint64_t> rows{0};
+        std::atomic<uint64_t> slow{0};
+        std::array<std::atomic<uint64_t>, kHistogramBuckets> histogram{};
+    };
+
+    struct Summary {
+        std::string fingerprint;
+        uint64_t count;
+        uint64_t totalUs;
+        uint64_t p50Us;
+        uint64_t p99Us;
+        uint64_t maxUs;
+        uint64_t rows;
+        uint64_t slow;
+    };
+
+    // Normalize SQL text: literals become ?, whitespace collapses and value lists fold,
+    // so every execution of the same statement shape lands on one fingerprint
+    static std::string fingerprint(const std::string& query);
+
+    // Number of ? placeholders outside quoted text
+    static int countParameters(const std::string& query);
+
+    // Look up (or create) the entry for a statement; resolve once and keep the pointer where the
+    // SQL repeats (prepared statements). Plain SQL with its values inlined, such as a QueryBatch
+    // or a BulkInsert chunk, has to be fingerprinted and looked up on every execution.
+    Entry* entryFor(const std::string& query);
+
+    // Record one execution, writing it to the slow-query log when over the threshold
+    void record(Entry* entry, std::chrono::microseconds elapsed, uint64_t rows, int parameterCount);
+
+    void setSlowQueryThreshold(int thresholdMs) { slowQueryThresholdUs = static_cast<int64_t>(thresholdMs) * 1000; }
+
+    // Aggregated table, most total time first
+    std::vector<Summary> snapshot();
+
+    // Zero all counters; fingerprints stay registered
+    void reset();
+
+private:
+    QueryStats() : slowQueryThresholdUs(200000) {}
+
+    // Disable copy and move
+    QueryStats(const QueryStats&) = delete;
+    QueryStats& operator=(const QueryStats&) = delete;
+    QueryStats(QueryStats&&) = delete;
+    QueryStats& operator=(QueryStats&&) = delete;
+
+    static size_t bucketFor(uint64_t us);
+    static uint64_t bucketUpperBound(size_t bucket);
+    static uint64_t percentile(const Entry& entry, uint64_t count, double fraction);
+
+    // Caps the table when callers build SQL with unbounded variety
+    static constexpr size_t kMaxFingerprints = 1000;
+
+    // Guards entries: shared for lookups and reading, exclusive only to register a new fingerprint
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<Entry>> entries;
+    std::atomic<int64_t> slowQueryThresholdUs;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <mariadb/conncpp.hpp>
+
+// Isolation levels a transaction can run at; Default keeps the session's setting
+enum class IsolationLevel {
+    Default,
+    ReadUncommitted,
+    ReadCommitted,
+    RepeatableRead,
+    Serializable
+};
+
+// Scoped transaction on a single connection; rolls back on destruction unless committed.
+// Uses START TRANSACTION rather than switching autocommit off, so the connection
+// never has session state to restore when it goes back to the pool.
+class Transaction {
+public:
+    // Savepoint inside a transaction; rolls back to itself on destruction unless released
+    class Savepoint {
+    public:
+        Savepoint(Savepoint&& other) noexcept;
+        Savepoint& operator=(Savepoint&&) = delete;
+        Savepoint(const Savepoint&) = delete;
+        Savepoint& operator=(const Savepoint&) = delete;
+        ~Savepoint();
+
+        // Keep the work done since the savepoint
+        void release();
+        // Undo the work done since the savepoint; the transaction stays open
+        void rollback();
+
+    private:
+        friend class Transaction;
+        Savepoint(Transaction* transaction, std::string name);
+
+        Transaction* transaction;
+        std::string name;
+    };
+
+    Transaction(std::shared_ptr<sql::Connection> connection, IsolationLevel isolation = IsolationLevel::Default);
+    ~Transaction();
+
+    Transaction(Transaction&& other) noexcept;
+    Transaction& operator=(Transaction&&) = delete;
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    void commit();
+    void rollback();
+    bool isActive() const { return active; }
+
+    // Called once the transaction has ended, after COMMIT or ROLLBACK (even when they fail);
+    // clean is false when the statement failed, leaving the session's state unknown
+    void setOnEnd(std::function<void(bool clean)> callback) { onEnd = std::move(callback); }
+
+    // Savepoints nest: each one must be released or rolled back before the ones taken earlier.
+    // A transaction must not be moved while it has open savepoints.
+    Savepoint savepoint();
+
+private:
+    void execute(const std::string& sql);
+    // Send COMMIT or ROLLBACK and run the end callback
+    void finish(const std::string& sql);
+
+    std::shared_ptr<sql::Connection> connection;
+    std::function<void(bool clean)> onEnd;
+    bool active;
+    int savepointCount;
+};
@@ -4,15 +4,19 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <functional>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "../utils/Logger.h"
 #include "../utils/JWTUtils.h"
 #include "../database/DBConnectionPool.h"
+#include "UserStatusCache.h"
 
 // Use nlohmann::json explicitly
 using json = nlohmann::json;
 
-// Authentication middleware for Crow
+// Authentication middleware for Crow: verifies the bearer token once per request and keeps
+// the result in its context, where the helpers below read it
 struct AuthMiddleware {
     struct context {
         std::unordered_map<std::string, std::string> user;
@@ -22,97 +26,123 @@ struct AuthMiddleware {
     };
 
     void before_handle(crow::request& req, crow::response& res, context& ctx) {
+        authenticate(req, ctx);
+    }
+
+    void after_handle(crow::request& req, crow::response& res, context& ctx) {
+        // Nothing to do after handling
+    }
+
+    // Verify the request's token and check that its user still exists
+    static void authenticate(const crow::request& req, context& ctx) {
         try {
             // Get token from Authorization header
-            std::string authHeader = req.get_header_value("Authorization");
-
-            if (!authHeader.empty() && authHeader.substr(0, 7) == "Bearer ") {
-                std::string token = authHeader.substr(7);
-
-                // Verify token
-                std::unordered_map<std::string, std::string> payload;
-                if (JWTUtils::getInstance().verifyToken(token, payload)) {
-                    ctx.user = payload;
-                    ctx.authenticated = true;
-
-                    // Store role and user_id for easier access
-                    if (payload.count("role")) {
-                        ctx.role = payload["role"];
-                    }
-
-                    if (payload.count("id")) {
-                        ctx.user_id = std::stoi(payload["id"]);
-                    }
-
-                    // Check if user still exists in the database
-                    try {
-                        auto db = DBConnectionPool::getInstance().getConnection();
-                        auto stmt = db->prepareStatement("SELECT * FROM users WHERE user_id = ?");
-                        stmt->setInt(1, ctx.user_id);
-                        auto result = db->executeQuery(stmt);
-
-                        if (!result->next()) {
-                            ctx.authenticated = false;
-                        }
-                    } catch (const std::exception& e) {
-                        LOG_ERROR("Database error in auth middleware: " + std::string(e.what()));
-                        // Continue with the authentication we have
-                    }
+            const std::string& authHeader = req.get_header_value("Authorization");
+
+            if (authHeader.size() <= 7 || authHeader.compare(0, 7, "Bearer ") != 0) {
+                return;
+            }
+
+            // Verify token
+            std::unordered_map<std::string, std::string> payload;
+            if (!JWTUtils::getInstance().verifyToken(authHeader.substr(7), payload)) {
+                return;
+            }
+
+            // Store role and user_id for easier access
+            if (payload.count("role")) {
+                ctx.role = payload["role"];
+            }
+
+            if (payload.count("id")) {
+                ctx.user_id = std::stoi(payload["id"]);
+            }
+
+            ctx.user = std::move(payload);
+            ctx.authenticated = true;
+
+            // Check if user still exists, and pick up a role changed since the token was issued
+            try {
+                auto status = UserStatusCache::getInstance().get(ctx.user_id);
+
+                if (!status.exists) {
+                    ctx.authenticated = false;
+                } else if (!status.role.empty() && status.role != ctx.role) {
+                    ctx.role = status.role;
+                    ctx.user["role"] = status.role;
                 }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Database error in auth middleware: " + std::string(e.what()));
+                // Continue with the authentication we have
             }
         } catch (const std::exception& e) {
             LOG_ERROR("Auth middleware error: " + std::string(e.what()));
-            // Continue processing
+            ctx = context();
         }
     }
 
-    void after_handle(crow::request& req, crow::response& res, context& ctx) {
-        // Nothing to do after handling
+    // Let the helpers find the context of the app's requests; call once after creating the app
+    template <typename App>
+    static void bind(App& app) {
+        lookup() = [&app](const crow::request& req) -> const context* {
+            if (!req.middleware_context) {
+                return nullptr;
+            }
+            return &app.template get_context<AuthMiddleware>(req);
+        };
+    }
+
+    // Context filled for this request, or nullptr when the middleware did not run
+    static const context* find(const crow::request& req) {
+        const auto& fn = lookup();
+        return fn ? fn(req) : nullptr;
     }
-};
 
-// Since we can't directly access the middleware context, let's create a lightweight auth system
-// that doesn't depend on the middleware context, but rather processes the request directly
+private:
+    static std::function<const context*(const crow::request&)>& lookup() {
+        static std::function<const context*(const crow::request&)> fn;
+        return fn;
+    }
+};
 
 /**
- * Helper function to check if a request is authenticated
+ * Authentication result for a request, as filled in by AuthMiddleware.
+ * Requests that did not go through the middleware are verified on the spot.
  */
-inline bool is_authenticated(const crow::request& req) {
-    std::string authHeader = req.get_header_value("Authorization");
-
-    if (authHeader.empty() || authHeader.substr(0, 7) != "Bearer ") {
-        return false;
+inline const AuthMiddleware::context& get_auth_context(const crow::request& req) {
+    if (const auto* ctx = AuthMiddleware::find(req)) {
+        return *ctx;
     }
 
-    std::string token = authHeader.substr(7);
-    std::unordered_map<std::string, std::string> payload;
+    thread_local AuthMiddleware::context fallback;
+    fallback = AuthMiddleware::context();
+    AuthMiddleware::authenticate(req, fallback);
+    return fallback;
+}
 
-    return JWTUtils::getInstance().verifyToken(token, payload);
+/**
+ * Helper function to check if a request is authenticated
+ */
+inline bool is_authenticated(const crow::request& req) {
+    return get_auth_context(req).authenticated;
 }
 
 /**
  * Helper function to extract user data from a request
  */
 inline std::unordered_map<std::string, std::string> get_user_data(const crow::request& req) {
-    std::unordered_map<std::string, std::string> payload;
-    std::string authHeader = req.get_header_value("Authorization");
-
-    if (!authHeader.empty() && authHeader.substr(0, 7) == "Bearer ") {
-        std::string token = authHeader.substr(7);
-        JWTUtils::getInstance().verifyToken(token, payload);
-    }
-
-    return payload;
+    const auto& ctx = get_auth_context(req);
+    return ctx.authenticated ? ctx.user : std::unordered_map<std::string, std::string>();
 }
 
 /**
  * Helper function to check if a user has the required role
  */
 inline bool has_role(const crow::request& req, const std::vector<std::string>& roles) {
-    auto userData = get_user_data(req);
+    const auto& ctx = get_auth_context(req);
 
     // If not authenticated or no role info
-    if (userData.empty() || userData.find("role") == userData.end()) {
+    if (!ctx.authenticated || ctx.role.empty()) {
         return false;
     }
 
@@ -122,9 +152,8 @@ inline bool has_role(const crow::request& req, const std::vector<std::string>& r
     }
 
     // Check if user has any of the required roles
-    std::string userRole = userData["role"];
     for (const auto& role : roles) {
-        if (userRole == role) {
+        if (ctx.role == role) {
             return true;
         }
     }
@@ -136,13 +165,8 @@ inline bool has_role(const crow::request& req, const std::vector<std::string>& r
  * Helper function to get user ID from request
  */
 inline int get_user_id(const crow::request& req) {
-    auto userData = get_user_data(req);
-
-    if (userData.empty() || userData.find("id") == userData.end()) {
-        return 0;
-    }
-
-    return std::stoi(userData["id"]);
+    const auto& ctx = get_auth_context(req);
+    return ctx.authenticated ? ctx.user_id : 0;
 }
 
 /**
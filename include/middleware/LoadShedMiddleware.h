@@ -0,0 +1,52 @@
+#pragma once
+
+#include <crow.h>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "../utils/Logger.h"
+#include "../database/DBConnectionPool.h"
+
+/**
+ * Helper function to create the response for work turned away under load or during an outage
+ */
+inline crow::response overload_error(const PoolSaturatedError& e) {
+    nlohmann::json error;
+    error["success"] = false;
+    error["error"] = e.getReason() == PoolSaturatedError::Reason::CircuitOpen
+        ? "Database temporarily unavailable, please retry later"
+        : "Service temporarily overloaded, please retry later";
+
+    crow::response res(503, error.dump(4));
+    res.set_header("Retry-After", std::to_string(e.getRetryAfterSeconds()));
+    return res;
+}
+
+// Admission control: while the database wait queues are full, reject requests before
+// authentication or any handler work runs. Requests that get past it can still be shed
+// by the pool's deadline; handlers answer those with overload_error as well.
+struct LoadShedMiddleware {
+    struct context {};
+
+    void before_handle(crow::request& req, crow::response& res, context& ctx) {
+        // Health checks report saturation themselves and never take a pooled connection
+        if (req.url.rfind("/health", 0) == 0) {
+            return;
+        }
+
+        auto& pool = DBConnectionPool::getInstance();
+        if (!pool.isSaturated()) {
+            return;
+        }
+
+        PoolSaturatedError shed(PoolSaturatedError::Reason::QueueFull, "Database wait queue is full",
+                                pool.getRetryAfterSeconds());
+        LOG_DEBUG("Shedding request: " + req.url);
+
+        res = overload_error(shed);
+        res.end();
+    }
+
+    void after_handle(crow::request& req, crow::response& res, context& ctx) {
+        // Nothing to do after handling
+    }
+};
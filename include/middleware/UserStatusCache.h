@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <array>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Whether a token's user still exists and the role they hold now, kept briefly so
+// authenticated requests do not each need a database round trip. An entry is refetched
+// once its TTL passes or after invalidate(); the TTL bounds how long a deleted user or a
+// changed role can go unnoticed.
+class UserStatusCache {
+public:
+    static UserStatusCache& getInstance() {
+        static UserStatusCache instance;
+        return instance;
+    }
+
+    struct Status {
+        bool exists;
+        std::string role;
+    };
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t invalidations;
+        uint64_t entries;
+    };
+
+    // Status of a user, from the cache or the database; throws when the database cannot be reached
+    Status get(int userId);
+
+    // Forget one user, e.g. after their password or role changed
+    void invalidate(int userId);
+
+    // 0 disables the cache (call before serving requests)
+    void setTtl(int ttlMs) { this->ttl = std::chrono::milliseconds(ttlMs); }
+    void setMaxEntries(size_t entries) { this->maxEntries = entries; }
+
+    Stats getStats();
+    void clear();
+
+private:
+    UserStatusCache() : ttl(5000), maxEntries(10000), generation(0), hits(0), misses(0), invalidations(0) {}
+
+    // Disable copy and move
+    UserStatusCache(const UserStatusCache&) = delete;
+    UserStatusCache& operator=(const UserStatusCache&) = delete;
+    UserStatusCache(UserStatusCache&&) = delete;
+    UserStatusCache& operator=(UserStatusCache&&) = delete;
+
+    static Status fetch(int userId);
+
+    struct Entry {
+        Status status;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<int, Entry> entries;
+    };
+
+    static constexpr size_t kShards = 16;
+
+    Shard& shardFor(int userId) { return shards[static_cast<unsigned int>(userId) % kShards]; }
+
+    std::array<Shard, kShards> shards;
+    std::chrono::milliseconds ttl;
+    std::atomic<size_t> maxEntries;
+    std::atomic<uint64_t> generation; // bumped by invalidate(), so fetches already running are not stored
+
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> invalidations;
+};
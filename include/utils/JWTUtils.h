@@ -3,6 +3,11 @@
 #include <string>
 #include <unordered_map>
 #include <chrono>
+#include <list>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
 #include <jwt-cpp/jwt.h>
 
 class JWTUtils {
@@ -15,17 +20,36 @@ public:
     // Generate JWT token for a user
     std::string generateToken(int userId, const std::string& role = "user");
 
-    // Verify JWT token and return payload if valid
+    struct CacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t expired;   // cached tokens dropped because they reached exp
+        uint64_t evictions; // dropped to stay within the entry limit
+        uint64_t entries;
+        uint64_t maxEntries;
+        uint64_t verifyUs;  // time spent on full verifications (misses)
+        uint64_t savedUs;   // estimated time hits saved, at the average cost of a miss
+    };
+
+    // Verify JWT token and return payload if valid; tokens verified before are answered from the cache
     bool verifyToken(const std::string& token, std::unordered_map<std::string, std::string>& payload);
 
-    // Set secret key from config
-    void setSecret(const std::string& secret) { this->secret = secret; }
+    // Set secret key from config; drops every cached verification
+    void setSecret(const std::string& secret);
 
     // Set token expiration time in seconds
     void setExpiresIn(int expiresIn) { this->expiresIn = expiresIn; }
+    int getExpiresIn() const { return expiresIn; }
+
+    // Verified tokens to keep; 0 disables the cache
+    void setCacheSize(size_t entries) { this->cacheSize = entries; }
+
+    CacheStats getCacheStats();
+    void clearCache();
 
 private:
-    JWTUtils() : expiresIn(2592000) {} // Default 30 days
+    JWTUtils() : expiresIn(2592000), cacheSize(10000), cacheGeneration(0), cacheHits(0), cacheMisses(0),
+                 cacheExpired(0), cacheEvictions(0), verifyUs(0) {} // expiresIn defaults to 30 days
     ~JWTUtils() = default;
 
     // Disable copy and move
@@ -34,6 +58,42 @@ private:
     JWTUtils(JWTUtils&&) = delete;
     JWTUtils& operator=(JWTUtils&&) = delete;
 
+    // Full decode and signature check, no cache
+    bool verifyUncached(const std::string& token, std::unordered_map<std::string, std::string>& payload,
+                        std::chrono::system_clock::time_point& expiresAt, std::chrono::system_clock::time_point& issuedAt);
+
+    // Logged out, or issued before the user's password changed
+    static bool isRevoked(const std::unordered_map<std::string, std::string>& payload,
+                          std::chrono::system_clock::time_point issuedAt);
+
+    // Random jti for a new token, so it can be revoked on its own
+    static std::string newTokenId();
+
+    struct CachedToken {
+        std::string token; // compared on lookup, so a digest collision is only a miss
+        std::unordered_map<std::string, std::string> payload;
+        std::chrono::system_clock::time_point expiresAt;
+        std::chrono::system_clock::time_point issuedAt;
+    };
+
+    // One LRU list per shard, indexed by token digest
+    struct CacheShard {
+        std::mutex mutex;
+        std::list<CachedToken> lru; // most recently used first
+        std::unordered_map<size_t, std::list<CachedToken>::iterator> index;
+    };
+
+    static constexpr size_t kCacheShards = 16;
+
     std::string secret = "simpleSecretKey123"; // Default, should be updated from config
     int expiresIn;
+
+    std::array<CacheShard, kCacheShards> cacheShards;
+    std::atomic<size_t> cacheSize;
+    std::atomic<uint64_t> cacheGeneration; // bumped with the secret, so in-flight verifications are not stored
+    std::atomic<uint64_t> cacheHits;
+    std::atomic<uint64_t> cacheMisses;
+    std::atomic<uint64_t> cacheExpired;
+    std::atomic<uint64_t> cacheEvictions;
+    std::atomic<uint64_t> verifyUs;
 };
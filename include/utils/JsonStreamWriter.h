@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <mariadb/conncpp.hpp>
+
+/**
+ * Writes pretty-printed JSON (same layout as json::dump(4)) straight into a
+ * string, without building a json document first. Used for list endpoints
+ * where the rows are copied from a ResultSet into the response body once.
+ */
+class JsonStreamWriter {
+public:
+    enum class ColumnType { Int, Double, String };
+
+    struct Column {
+        std::string name;
+        ColumnType type;
+    };
+
+    explicit JsonStreamWriter(std::string& out, int indent = 4);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    // Object member name; must be followed by a value, object or array
+    void key(const std::string& name);
+
+    void value(int64_t number);
+    void value(int number) { value(static_cast<int64_t>(number)); }
+    void value(double number);
+    void value(bool flag);
+    void value(const std::string& text);
+    void value(const char* text) { value(std::string(text)); }
+    void null();
+
+    // Most rows writeRows emits by default. Crow here sends a response body as one string,
+    // so the whole array is held in memory; callers LIMIT their query to kMaxRows + 1.
+    static constexpr size_t kMaxRows = 5000;
+
+    /**
+     * Write the remaining rows of the result set, up to maxRows, as objects with the given
+     * columns; SQL NULL becomes JSON null. Rows past maxRows are left unread.
+     * @return Number of rows written
+     */
+    size_t writeRows(sql::ResultSet& result, const std::vector<Column>& columns, size_t maxRows = kMaxRows);
+
+private:
+    // Separator, newline and indentation before the next element
+    void prefix();
+    void newline();
+    void writeString(const std::string& text);
+
+    struct Scope {
+        bool array;
+        size_t count;
+    };
+
+    std::string& out;
+    int indent;
+    std::vector<Scope> scopes;
+    bool afterKey;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <future>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+// Thrown when the hasher already has its limit of calls in flight; handlers answer 429 so
+// clients back off
+class PasswordHasherBusyError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// PBKDF2-HMAC-SHA256 password hashes, computed on a small dedicated thread pool so a burst
+// of logins cannot spend every HTTP worker on key derivation. A caller waits on its HTTP
+// thread for the result, so at most threads + maxQueued calls are admitted at a time and the
+// rest are refused at once; keep that below the HTTP thread count. Hashes are stored as
+// pbkdf2_sha256$<iterations>$<salt hex>$<hash hex>; any other stored value is a legacy
+// plaintext password, which verify() still accepts and flags for rehashing.
+class PasswordHasher {
+public:
+    static PasswordHasher& getInstance() {
+        static PasswordHasher instance;
+        return instance;
+    }
+
+    struct Verification {
+        bool valid;
+        bool needsRehash; // legacy value or fewer iterations than configured
+    };
+
+    // Start the worker threads; maxQueued bounds the hashes waiting for a free thread
+    void start(int threads, int maxQueued = 2);
+
+    // Finish queued work and join the worker threads
+    void stop();
+
+    // PBKDF2 work factor for new hashes; existing hashes keep theirs until rehashed
+    void setIterations(int iterations) { this->iterations = iterations; }
+    int getIterations() const { return iterations; }
+
+    // Run on the pool and wait for the result; inline when the pool is not started.
+    // Throw PasswordHasherBusyError when threads + maxQueued calls are already in flight.
+    std::string hash(const std::string& password);
+    Verification verify(const std::string& password, const std::string& stored);
+
+    // Run job on the pool without waiting for it, but only if a thread is idle right now, so
+    // background work never takes a place a request could use. Returns false (and drops the
+    // job) when every thread is busy; runs it inline when the pool is not started.
+    bool runWhenIdle(std::function<void()> job);
+
+    // The same work on the calling thread
+    std::string hashNow(const std::string& password);
+    Verification verifyNow(const std::string& password, const std::string& stored);
+
+    // Statistics
+    int getThreadCount() const { return static_cast<int>(workers.size()); }
+    int getQueuedCount() const { return queued; }
+    int getActiveCount() const { return active; }
+    uint64_t getRejectedCount() const { return rejected; }
+
+private:
+    PasswordHasher() : iterations(600000), maxQueued(2), running(false), queued(0), active(0), rejected(0) {}
+    ~PasswordHasher();
+
+    // Disable copy and move
+    PasswordHasher(const PasswordHasher&) = delete;
+    PasswordHasher& operator=(const PasswordHasher&) = delete;
+    PasswordHasher(PasswordHasher&&) = delete;
+    PasswordHasher& operator=(PasswordHasher&&) = delete;
+
+    template<typename F>
+    auto run(F&& fn) -> std::invoke_result_t<std::decay_t<F>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+        auto future = task->get_future();
+
+        if (!enqueue([task]() { (*task)(); })) {
+            (*task)();
+        }
+
+        return future.get();
+    }
+
+    // Returns false when the pool is not running
+    bool enqueue(std::function<void()> job);
+    void workerLoop();
+
+    std::atomic<int> iterations;
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    size_t maxQueued;
+    bool running;
+
+    // Written under mutex, so jobs.size() + active is exact there
+    std::atomic<int> queued;
+    std::atomic<int> active;
+    std::atomic<uint64_t> rejected;
+};
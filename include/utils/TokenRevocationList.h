@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+
+// Tokens that were signed validly but must no longer be accepted: single tokens by their
+// jti (logout), and every token of a user issued before a point in time (password change).
+// Checking a token is two hash probes. An entry is only needed until the tokens it covers
+// expire on their own, so entries sit in a timer wheel slotted by that expiry and are
+// dropped as the wheel turns. Revocations are appended to a local file and reloaded on start.
+class TokenRevocationList {
+public:
+    using Clock = std::chrono::system_clock;
+
+    static TokenRevocationList& getInstance() {
+        static TokenRevocationList instance;
+        return instance;
+    }
+
+    struct Stats {
+        uint64_t tokens;  // single tokens revoked
+        uint64_t users;   // users with all earlier tokens revoked
+        uint64_t dropped; // entries dropped after their tokens expired
+    };
+
+    // Load revocations saved by an earlier run from path and append new ones to it;
+    // an empty path keeps them in memory only
+    bool open(const std::string& path);
+
+    // Reject one token until its own expiry
+    void revokeToken(const std::string& tokenId, Clock::time_point expiresAt);
+
+    // Reject every token of a user issued before now; until is when the last of them expires
+    void revokeUser(int userId, Clock::time_point until);
+
+    // tokenId may be empty for tokens issued without a jti
+    bool isRevoked(const std::string& tokenId, int userId, Clock::time_point issuedAt);
+
+    Stats getStats();
+
+private:
+    TokenRevocationList();
+
+    // Disable copy and move
+    TokenRevocationList(const TokenRevocationList&) = delete;
+    TokenRevocationList& operator=(const TokenRevocationList&) = delete;
+    TokenRevocationList(TokenRevocationList&&) = delete;
+    TokenRevocationList& operator=(TokenRevocationList&&) = delete;
+
+    struct UserEpoch {
+        Clock::time_point revokedBefore;
+        Clock::time_point until;
+    };
+
+    struct Timer {
+        std::string tokenId; // empty for a user epoch
+        int userId;
+        Clock::time_point expiresAt;
+    };
+
+    // Callers hold the exclusive lock
+    bool addToken(const std::string& tokenId, Clock::time_point expiresAt, Clock::time_point now);
+    bool addUser(int userId, UserEpoch epoch, Clock::time_point now);
+    void schedule(Timer timer);
+    size_t advance(Clock::time_point now);
+    void rewriteFile();
+
+    static int64_t toSeconds(Clock::time_point time);
+    static Clock::time_point fromSeconds(int64_t seconds);
+
+    // 1024 one-minute slots; entries further out stay in their slot across turns
+    static constexpr size_t kWheelSlots = 1024;
+    static constexpr std::chrono::seconds kTick{60};
+
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, Clock::time_point> tokens; // jti -> expiry
+    std::unordered_map<int, UserEpoch> users;
+    std::array<std::vector<Timer>, kWheelSlots> wheel;
+    int64_t wheelTick; // last tick whose slot has been processed
+    uint64_t dropped;
+
+    std::string path;
+    std::ofstream file;
+};
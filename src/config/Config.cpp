@@ -95,6 +95,190 @@ bool Config::load(const std::string& filename) {
             } else {
                 LOG_WARNING("Database does not contain 'poolSize'");
             }
+
+            if (db.contains("minPool")) {
+                dbMinPool = db["minPool"].get<int>();
+                LOG_DEBUG("Loaded dbMinPool: " + std::to_string(dbMinPool));
+            } else {
+                LOG_WARNING("Database does not contain 'minPool'");
+            }
+
+            if (db.contains("maxPool")) {
+                dbMaxPool = db["maxPool"].get<int>();
+                LOG_DEBUG("Loaded dbMaxPool: " + std::to_string(dbMaxPool));
+            } else {
+                LOG_WARNING("Database does not contain 'maxPool'");
+            }
+
+            if (db.contains("idleTimeoutMs")) {
+                dbIdleTimeoutMs = db["idleTimeoutMs"].get<int>();
+                LOG_DEBUG("Loaded dbIdleTimeoutMs: " + std::to_string(dbIdleTimeoutMs));
+            } else {
+                LOG_WARNING("Database does not contain 'idleTimeoutMs'");
+            }
+
+            if (db.contains("acquireTimeoutMs")) {
+                dbAcquireTimeoutMs = db["acquireTimeoutMs"].get<int>();
+                LOG_DEBUG("Loaded dbAcquireTimeoutMs: " + std::to_string(dbAcquireTimeoutMs));
+            } else {
+                LOG_WARNING("Database does not contain 'acquireTimeoutMs'");
+            }
+
+            if (db.contains("statementCacheSize")) {
+                dbStatementCacheSize = db["statementCacheSize"].get<int>();
+                LOG_DEBUG("Loaded dbStatementCacheSize: " + std::to_string(dbStatementCacheSize));
+            } else {
+                LOG_WARNING("Database does not contain 'statementCacheSize'");
+            }
+
+            if (db.contains("warmupQuorum")) {
+                dbWarmupQuorum = db["warmupQuorum"].get<int>();
+                LOG_DEBUG("Loaded dbWarmupQuorum: " + std::to_string(dbWarmupQuorum));
+            } else {
+                LOG_WARNING("Database does not contain 'warmupQuorum'");
+            }
+
+            if (db.contains("replicas")) {
+                dbReplicas.clear();
+                for (auto& r : db["replicas"]) {
+                    DbReplicaConfig replica;
+                    replica.host = r["host"].get<std::string>();
+                    replica.port = r.value("port", dbPort);
+                    replica.user = r.value("user", dbUser);
+                    replica.password = r.value("password", dbPassword);
+                    replica.name = r.value("name", dbName);
+                    dbReplicas.push_back(replica);
+                }
+                LOG_DEBUG("Loaded dbReplicas: " + std::to_string(dbReplicas.size()));
+            } else {
+                LOG_WARNING("Database does not contain 'replicas'");
+            }
+
+            if (db.contains("replicaSelection")) {
+                dbReplicaSelection = db["replicaSelection"].get<std::string>();
+                LOG_DEBUG("Loaded dbReplicaSelection: " + dbReplicaSelection);
+            } else {
+                LOG_WARNING("Database does not contain 'replicaSelection'");
+            }
+
+            if (db.contains("readYourWritesMs")) {
+                dbReadYourWritesMs = db["readYourWritesMs"].get<int>();
+                LOG_DEBUG("Loaded dbReadYourWritesMs: " + std::to_string(dbReadYourWritesMs));
+            } else {
+                LOG_WARNING("Database does not contain 'readYourWritesMs'");
+            }
+
+            if (db.contains("executorThreads")) {
+                dbExecutorThreads = db["executorThreads"].get<int>();
+                LOG_DEBUG("Loaded dbExecutorThreads: " + std::to_string(dbExecutorThreads));
+            } else {
+                LOG_WARNING("Database does not contain 'executorThreads'");
+            }
+
+            if (db.contains("executorQueueSize")) {
+                dbExecutorQueueSize = db["executorQueueSize"].get<int>();
+                LOG_DEBUG("Loaded dbExecutorQueueSize: " + std::to_string(dbExecutorQueueSize));
+            } else {
+                LOG_WARNING("Database does not contain 'executorQueueSize'");
+            }
+
+            if (db.contains("slowQueryMs")) {
+                dbSlowQueryMs = db["slowQueryMs"].get<int>();
+                LOG_DEBUG("Loaded dbSlowQueryMs: " + std::to_string(dbSlowQueryMs));
+            } else {
+                LOG_WARNING("Database does not contain 'slowQueryMs'");
+            }
+
+            if (db.contains("threadAffinity")) {
+                dbThreadAffinity = db["threadAffinity"].get<bool>();
+                LOG_DEBUG("Loaded dbThreadAffinity: " + std::string(dbThreadAffinity ? "true" : "false"));
+            } else {
+                LOG_WARNING("Database does not contain 'threadAffinity'");
+            }
+
+            if (db.contains("affinityIdleMs")) {
+                dbAffinityIdleMs = db["affinityIdleMs"].get<int>();
+                LOG_DEBUG("Loaded dbAffinityIdleMs: " + std::to_string(dbAffinityIdleMs));
+            } else {
+                LOG_WARNING("Database does not contain 'affinityIdleMs'");
+            }
+
+            if (db.contains("healthProbeMs")) {
+                dbHealthProbeMs = db["healthProbeMs"].get<int>();
+                LOG_DEBUG("Loaded dbHealthProbeMs: " + std::to_string(dbHealthProbeMs));
+            } else {
+                LOG_WARNING("Database does not contain 'healthProbeMs'");
+            }
+
+            if (db.contains("queryCacheMb")) {
+                dbQueryCacheMb = db["queryCacheMb"].get<int>();
+                LOG_DEBUG("Loaded dbQueryCacheMb: " + std::to_string(dbQueryCacheMb));
+            } else {
+                LOG_WARNING("Database does not contain 'queryCacheMb'");
+            }
+
+            if (db.contains("queryCacheTtlMs")) {
+                dbQueryCacheTtlMs = db["queryCacheTtlMs"].get<int>();
+                LOG_DEBUG("Loaded dbQueryCacheTtlMs: " + std::to_string(dbQueryCacheTtlMs));
+            } else {
+                LOG_WARNING("Database does not contain 'queryCacheTtlMs'");
+            }
+
+            if (db.contains("maxWaiters")) {
+                dbMaxWaiters = db["maxWaiters"].get<int>();
+                LOG_DEBUG("Loaded dbMaxWaiters: " + std::to_string(dbMaxWaiters));
+            } else {
+                LOG_WARNING("Database does not contain 'maxWaiters'");
+            }
+
+            if (db.contains("queuePolicy")) {
+                dbQueuePolicy = db["queuePolicy"].get<std::string>();
+                LOG_DEBUG("Loaded dbQueuePolicy: " + dbQueuePolicy);
+            } else {
+                LOG_WARNING("Database does not contain 'queuePolicy'");
+            }
+
+            if (db.contains("queueTargetMs")) {
+                dbQueueTargetMs = db["queueTargetMs"].get<int>();
+                LOG_DEBUG("Loaded dbQueueTargetMs: " + std::to_string(dbQueueTargetMs));
+            } else {
+                LOG_WARNING("Database does not contain 'queueTargetMs'");
+            }
+
+            if (db.contains("queueIntervalMs")) {
+                dbQueueIntervalMs = db["queueIntervalMs"].get<int>();
+                LOG_DEBUG("Loaded dbQueueIntervalMs: " + std::to_string(dbQueueIntervalMs));
+            } else {
+                LOG_WARNING("Database does not contain 'queueIntervalMs'");
+            }
+
+            if (db.contains("adaptiveLimit")) {
+                dbAdaptiveLimit = db["adaptiveLimit"].get<bool>();
+                LOG_DEBUG("Loaded dbAdaptiveLimit: " + std::string(dbAdaptiveLimit ? "true" : "false"));
+            } else {
+                LOG_WARNING("Database does not contain 'adaptiveLimit'");
+            }
+
+            if (db.contains("adaptiveLimitTolerance")) {
+                dbAdaptiveLimitTolerance = db["adaptiveLimitTolerance"].get<double>();
+                LOG_DEBUG("Loaded dbAdaptiveLimitTolerance: " + std::to_string(dbAdaptiveLimitTolerance));
+            } else {
+                LOG_WARNING("Database does not contain 'adaptiveLimitTolerance'");
+            }
+
+            if (db.contains("circuitFailureThreshold")) {
+                dbCircuitFailureThreshold = db["circuitFailureThreshold"].get<int>();
+                LOG_DEBUG("Loaded dbCircuitFailureThreshold: " + std::to_string(dbCircuitFailureThreshold));
+            } else {
+                LOG_WARNING("Database does not contain 'circuitFailureThreshold'");
+            }
+
+            if (db.contains("circuitOpenMs")) {
+                dbCircuitOpenMs = db["circuitOpenMs"].get<int>();
+                LOG_DEBUG("Loaded dbCircuitOpenMs: " + std::to_string(dbCircuitOpenMs));
+            } else {
+                LOG_WARNING("Database does not contain 'circuitOpenMs'");
+            }
         } else {
             LOG_WARNING("Config does not contain 'database' section");
         }
@@ -117,10 +301,66 @@ bool Config::load(const std::string& filename) {
             } else {
                 LOG_WARNING("JWT does not contain 'expiresIn'");
             }
+
+            if (jwt.contains("cacheSize")) {
+                jwtCacheSize = jwt["cacheSize"].get<int>();
+                LOG_DEBUG("Loaded jwtCacheSize: " + std::to_string(jwtCacheSize));
+            } else {
+                LOG_WARNING("JWT does not contain 'cacheSize'");
+            }
+
+            if (jwt.contains("userCacheTtlMs")) {
+                jwtUserCacheTtlMs = jwt["userCacheTtlMs"].get<int>();
+                LOG_DEBUG("Loaded jwtUserCacheTtlMs: " + std::to_string(jwtUserCacheTtlMs));
+            } else {
+                LOG_WARNING("JWT does not contain 'userCacheTtlMs'");
+            }
+
+            if (jwt.contains("userCacheSize")) {
+                jwtUserCacheSize = jwt["userCacheSize"].get<int>();
+                LOG_DEBUG("Loaded jwtUserCacheSize: " + std::to_string(jwtUserCacheSize));
+            } else {
+                LOG_WARNING("JWT does not contain 'userCacheSize'");
+            }
+
+            if (jwt.contains("revocationFile")) {
+                jwtRevocationFile = jwt["revocationFile"].get<std::string>();
+                LOG_DEBUG("Loaded jwtRevocationFile: " + jwtRevocationFile);
+            } else {
+                LOG_WARNING("JWT does not contain 'revocationFile'");
+            }
         } else {
             LOG_WARNING("Config does not contain 'jwt' section");
         }
 
+        // Load password hashing configuration
+        if (config.contains("password")) {
+            auto& password = config["password"];
+
+            if (password.contains("iterations")) {
+                passwordIterations = password["iterations"].get<int>();
+                LOG_DEBUG("Loaded passwordIterations: " + std::to_string(passwordIterations));
+            } else {
+                LOG_WARNING("Password does not contain 'iterations'");
+            }
+
+            if (password.contains("hashThreads")) {
+                passwordHashThreads = password["hashThreads"].get<int>();
+                LOG_DEBUG("Loaded passwordHashThreads: " + std::to_string(passwordHashThreads));
+            } else {
+                LOG_WARNING("Password does not contain 'hashThreads'");
+            }
+
+            if (password.contains("hashQueueSize")) {
+                passwordHashQueueSize = password["hashQueueSize"].get<int>();
+                LOG_DEBUG("Loaded passwordHashQueueSize: " + std::to_string(passwordHashQueueSize));
+            } else {
+                LOG_WARNING("Password does not contain 'hashQueueSize'");
+            }
+        } else {
+            LOG_WARNING("Config does not contain 'password' section");
+        }
+
         // Print default values vs loaded values
         LOG_INFO("Current configuration after loading:");
         LOG_INFO("port: " + std::to_string(port));
@@ -130,8 +370,40 @@ bool Config::load(const std::string& filename) {
         LOG_INFO("dbName: " + dbName);
         LOG_INFO("dbPort: " + std::to_string(dbPort));
         LOG_INFO("dbPoolSize: " + std::to_string(dbPoolSize));
+        LOG_INFO("dbMinPool: " + std::to_string(dbMinPool));
+        LOG_INFO("dbMaxPool: " + std::to_string(dbMaxPool));
+        LOG_INFO("dbIdleTimeoutMs: " + std::to_string(dbIdleTimeoutMs));
+        LOG_INFO("dbAcquireTimeoutMs: " + std::to_string(dbAcquireTimeoutMs));
+        LOG_INFO("dbStatementCacheSize: " + std::to_string(dbStatementCacheSize));
+        LOG_INFO("dbWarmupQuorum: " + std::to_string(dbWarmupQuorum));
+        LOG_INFO("dbReplicas: " + std::to_string(dbReplicas.size()));
+        LOG_INFO("dbReplicaSelection: " + dbReplicaSelection);
+        LOG_INFO("dbReadYourWritesMs: " + std::to_string(dbReadYourWritesMs));
+        LOG_INFO("dbExecutorThreads: " + std::to_string(dbExecutorThreads));
+        LOG_INFO("dbExecutorQueueSize: " + std::to_string(dbExecutorQueueSize));
+        LOG_INFO("dbSlowQueryMs: " + std::to_string(dbSlowQueryMs));
+        LOG_INFO("dbThreadAffinity: " + std::string(dbThreadAffinity ? "true" : "false"));
+        LOG_INFO("dbAffinityIdleMs: " + std::to_string(dbAffinityIdleMs));
+        LOG_INFO("dbHealthProbeMs: " + std::to_string(dbHealthProbeMs));
+        LOG_INFO("dbQueryCacheMb: " + std::to_string(dbQueryCacheMb));
+        LOG_INFO("dbQueryCacheTtlMs: " + std::to_string(dbQueryCacheTtlMs));
+        LOG_INFO("dbMaxWaiters: " + std::to_string(dbMaxWaiters));
+        LOG_INFO("dbQueuePolicy: " + dbQueuePolicy);
+        LOG_INFO("dbQueueTargetMs: " + std::to_string(dbQueueTargetMs));
+        LOG_INFO("dbQueueIntervalMs: " + std::to_string(dbQueueIntervalMs));
+        LOG_INFO("dbAdaptiveLimit: " + std::string(dbAdaptiveLimit ? "true" : "false"));
+        LOG_INFO("dbAdaptiveLimitTolerance: " + std::to_string(dbAdaptiveLimitTolerance));
+        LOG_INFO("dbCircuitFailureThreshold: " + std::to_string(dbCircuitFailureThreshold));
+        LOG_INFO("dbCircuitOpenMs: " + std::to_string(dbCircuitOpenMs));
         (jwtSecret.empty() ? LOG_INFO("jwtSecret: Not set") : LOG_INFO("jwtSecret: Set"));
         LOG_INFO("jwtExpiresIn: " + std::to_string(jwtExpiresIn));
+        LOG_INFO("jwtCacheSize: " + std::to_string(jwtCacheSize));
+        LOG_INFO("jwtUserCacheTtlMs: " + std::to_string(jwtUserCacheTtlMs));
+        LOG_INFO("jwtUserCacheSize: " + std::to_string(jwtUserCacheSize));
+        LOG_INFO("jwtRevocationFile: " + (jwtRevocationFile.empty() ? std::string("Not set") : jwtRevocationFile));
+        LOG_INFO("passwordIterations: " + std::to_string(passwordIterations));
+        LOG_INFO("passwordHashThreads: " + std::to_string(passwordHashThreads));
+        LOG_INFO("passwordHashQueueSize: " + std::to_string(passwordHashQueueSize));
 
         LOG_INFO("Configuration loaded successfully from " + filename);
         return true;
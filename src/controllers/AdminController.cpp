@@ -0,0 +1,179 @@
+#include "../../include/controllers/AdminController.h"
+#include "../../include/database/QueryStats.h"
+#include "../../include/database/QueryCache.h"
+#include "../../include/utils/JWTUtils.h"
+#include "../../include/middleware/UserStatusCache.h"
+#include "../../include/utils/Logger.h"
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+    double toMs(uint64_t us) {
+        return static_cast<double>(us) / 1000.0;
+    }
+}
+
+crow::response AdminController::getQueryStats(const crow::request& req) {
+    try {
+        auto table = QueryStats::getInstance().snapshot();
+
+        json stats = json::array();
+        for (const auto& row : table) {
+            json item;
+            item["fingerprint"] = row.fingerprint;
+            item["count"] = row.count;
+            item["total_ms"] = toMs(row.totalUs);
+            item["avg_ms"] = toMs(row.totalUs / row.count);
+            item["p50_ms"] = toMs(row.p50Us);
+            item["p99_ms"] = toMs(row.p99Us);
+            item["max_ms"] = toMs(row.maxUs);
+            item["rows"] = row.rows;
+            item["slow"] = row.slow;
+
+            stats.push_back(item);
+        }
+
+        json response = {
+            {"success", true},
+            {"count", stats.size()},
+            {"data", stats}
+        };
+
+        return crow::response(200, response.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in getQueryStats: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
+
+crow::response AdminController::resetQueryStats(const crow::request& req) {
+    try {
+        QueryStats::getInstance().reset();
+        LOG_INFO("Query statistics reset");
+
+        json response = {
+            {"success", true},
+            {"data", json::object()}
+        };
+
+        return crow::response(200, response.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in resetQueryStats: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
+
+crow::response AdminController::getQueryCacheStats(const crow::request& req) {
+    try {
+        auto stats = QueryCache::getInstance().getStats();
+        uint64_t lookups = stats.hits + stats.misses;
+
+        json data;
+        data["hits"] = stats.hits;
+        data["misses"] = stats.misses;
+        data["hit_ratio"] = lookups > 0 ? static_cast<double>(stats.hits) / static_cast<double>(lookups) : 0.0;
+        data["stale"] = stats.stale;
+        data["evictions"] = stats.evictions;
+        data["invalidations"] = stats.invalidations;
+        data["entries"] = stats.entries;
+        data["bytes"] = stats.bytes;
+        data["max_bytes"] = stats.maxBytes;
+
+        json response = {
+            {"success", true},
+            {"data", data}
+        };
+
+        return crow::response(200, response.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in getQueryCacheStats: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
+
+crow::response AdminController::clearQueryCache(const crow::request& req) {
+    try {
+        QueryCache::getInstance().clear();
+        LOG_INFO("Query result cache cleared");
+
+        json response = {
+            {"success", true},
+            {"data", json::object()}
+        };
+
+        return crow::response(200, response.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in clearQueryCache: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
+
+crow::response AdminController::getTokenCacheStats(const crow::request& req) {
+    try {
+        auto stats = JWTUtils::getInstance().getCacheStats();
+        uint64_t lookups = stats.hits + stats.misses;
+
+        json data;
+        data["hits"] = stats.hits;
+        data["misses"] = stats.misses;
+        data["hit_ratio"] = lookups > 0 ? static_cast<double>(stats.hits) / static_cast<double>(lookups) : 0.0;
+        data["expired"] = stats.expired;
+        data["evictions"] = stats.evictions;
+        data["entries"] = stats.entries;
+        data["max_entries"] = stats.maxEntries;
+        data["verify_ms"] = toMs(stats.verifyUs);
+        data["saved_ms"] = toMs(stats.savedUs);
+
+        // The user-existence check that follows each token verification
+        auto users = UserStatusCache::getInstance().getStats();
+        uint64_t userLookups = users.hits + users.misses;
+        data["users"] = {
+            {"hits", users.hits},
+            {"misses", users.misses},
+            {"hit_ratio", userLookups > 0 ? static_cast<double>(users.hits) / static_cast<double>(userLookups) : 0.0},
+            {"invalidations", users.invalidations},
+            {"entries", users.entries}
+        };
+
+        json response = {
+            {"success", true},
+            {"data", data}
+        };
+
+        return crow::response(200, response.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in getTokenCacheStats: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
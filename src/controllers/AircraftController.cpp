@@ -31,9 +31,6 @@ crow::response AircraftController::getAircraft(const crow::request& req) {
         // Calculate offset
         int offset = (page - 1) * limit;
 
-        // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
-
         // Prepare query for aircraft with crew information
         std::string query = R"(
             SELECT
@@ -52,18 +49,28 @@ crow::response AircraftController::getAircraft(const crow::request& req) {
             LIMIT ? OFFSET ?
         )";
 
-        auto stmt = db->prepareStatement(query);
-        stmt->setInt(1, limit);
-        stmt->setInt(2, offset);
+        QueryBatch queries;
+        queries.add("SELECT COUNT(*) as count FROM aircraft")
+            .add(query).bind(limit).bind(offset);
 
-        auto result = db->executeQuery(stmt);
+        // The list changes rarely; serve it from the result cache while none of its tables were written
+        auto cached = QueryCache::getInstance().lookup(queries.render(), {"aircraft", "crews", "crew_assignments"});
+        if (cached) {
+            return crow::response(200, *cached);
+        }
 
-        // Get total count
-        auto countStmt = db->prepareStatement("SELECT COUNT(*) as count FROM aircraft");
-        auto countResult = db->executeQuery(countStmt);
+        // Get database connection
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
+
+        // Fetch the total count and the page in one round trip
+        auto batch = db->executeBatch(queries);
+
+        auto countResult = batch.next();
         countResult->next();
         int totalCount = countResult->getInt("count");
 
+        auto result = batch.next();
+
         // Build response JSON
         json response;
         json aircraftArray = json::array();
@@ -101,7 +108,16 @@ crow::response AircraftController::getAircraft(const crow::request& req) {
         };
         response["data"] = aircraftArray;
 
-        return crow::response(200, response.dump(4));
+        // A replica may not have the latest writes yet; only a primary read is safe to keep as current
+        std::string body = response.dump(4);
+        if (db.isPrimary()) {
+            QueryCache::getInstance().store(cached, body);
+        }
+
+        return crow::response(200, body);
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
     }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getAircraft: " + std::string(e.what()));
@@ -128,7 +144,7 @@ crow::response AircraftController::getSingleAircraft(const crow::request& req) {
         int aircraftId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
 
         // Prepare query for aircraft with crew information
         std::string query = R"(
@@ -185,6 +201,9 @@ crow::response AircraftController::getSingleAircraft(const crow::request& req) {
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getSingleAircraft: " + std::string(e.what()));
 
@@ -226,7 +245,10 @@ crow::response AircraftController::createAircraft(const crow::request& req) {
         std::string status = requestData.contains("status") ? requestData["status"].get<std::string>() : "active";
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
+
+        // Checks and insert run in one transaction; it rolls back on any early return or error
+        auto transaction = db->beginTransaction();
 
         // Check if registration number already exists
         auto checkStmt = db->prepareStatement("SELECT COUNT(*) AS count FROM aircraft WHERE registration_number = ?");
@@ -242,8 +264,11 @@ crow::response AircraftController::createAircraft(const crow::request& req) {
         }
 
         // If crew_id is provided, validate crew
+        std::string crewName;
+        std::string crewStatus;
         if (crewId > 0) {
-            auto crewStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
+            // Shared lock: the crew's members cannot change until the aircraft is saved
+            auto crewStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ? LOCK IN SHARE MODE");
             crewStmt->setInt(1, crewId);
             auto crewResult = db->executeQuery(crewStmt);
 
@@ -254,6 +279,10 @@ crow::response AircraftController::createAircraft(const crow::request& req) {
                 return crow::response(404, error.dump(4));
             }
 
+            // Kept for the response so the new aircraft does not have to be read back
+            crewName = crewResult->getString("name");
+            crewStatus = crewResult->getString("status");
+
             // Validate crew composition
             // Check if crew has at least 1 captain, 1 pilot, and 2 flight attendants
             auto validateStmt = db->prepareStatement(R"(
@@ -301,7 +330,7 @@ crow::response AircraftController::createAircraft(const crow::request& req) {
 
         // Insert aircraft
         std::string insertQuery;
-        std::unique_ptr<sql::PreparedStatement> insertStmt;
+        std::shared_ptr<sql::PreparedStatement> insertStmt;
 
         if (crewId > 0) {
             insertQuery = R"(
@@ -309,7 +338,7 @@ crow::response AircraftController::createAircraft(const crow::request& req) {
                 (model, registration_number, capacity, manufacturing_year, crew_id, status)
                 VALUES (?, ?, ?, ?, ?, ?)
             )";
-            insertStmt = db->prepareStatement(insertQuery);
+            insertStmt = db->prepareInsert(insertQuery);
             insertStmt->setString(1, model);
             insertStmt->setString(2, registrationNumber);
             insertStmt->setInt(3, capacity);
@@ -322,7 +351,7 @@ crow::response AircraftController::createAircraft(const crow::request& req) {
                 (model, registration_number, capacity, manufacturing_year, status)
                 VALUES (?, ?, ?, ?, ?)
             )";
-            insertStmt = db->prepareStatement(insertQuery);
+            insertStmt = db->prepareInsert(insertQuery);
             insertStmt->setString(1, model);
             insertStmt->setString(2, registrationNumber);
             insertStmt->setInt(3, capacity);
@@ -330,54 +359,29 @@ crow::response AircraftController::createAircraft(const crow::request& req) {
             insertStmt->setString(5, status);
         }
 
-        db->executeUpdate(insertStmt);
+        int aircraftId = static_cast<int>(db->executeInsert(insertStmt));
 
-        // Get the last insert ID
-        auto idStmt = db->prepareStatement("SELECT LAST_INSERT_ID()");
-        auto idResult = db->executeQuery(idStmt);
-        idResult->next();
-        int aircraftId = idResult->getInt(1);
+        transaction.commit();
 
-        // Get the created aircraft
-        auto getStmt = db->prepareStatement(R"(
-            SELECT
-                a.aircraft_id,
-                a.model,
-                a.registration_number,
-                a.capacity,
-                a.manufacturing_year,
-                a.crew_id,
-                a.status,
-                c.name AS crew_name,
-                c.status AS crew_status
-            FROM aircraft a
-            LEFT JOIN crews c ON a.crew_id = c.crew_id
-            WHERE a.aircraft_id = ?
-        )");
-        getStmt->setInt(1, aircraftId);
-        auto getResult = db->executeQuery(getStmt);
-
-        getResult->next();
-
-        // Build response JSON
+        // Build response JSON from the inserted values; no read-back is needed
         json aircraft;
-        aircraft["aircraft_id"] = getResult->getInt("aircraft_id");
-        aircraft["model"] = getResult->getString("model");
-        aircraft["registration_number"] = getResult->getString("registration_number");
-        aircraft["capacity"] = getResult->getInt("capacity");
-        aircraft["manufacturing_year"] = getResult->getInt("manufacturing_year");
+        aircraft["aircraft_id"] = aircraftId;
+        aircraft["model"] = model;
+        aircraft["registration_number"] = registrationNumber;
+        aircraft["capacity"] = capacity;
+        aircraft["manufacturing_year"] = manufacturingYear;
 
-        if (!getResult->isNull("crew_id")) {
-            aircraft["crew_id"] = getResult->getInt("crew_id");
-            aircraft["crew_name"] = getResult->getString("crew_name");
-            aircraft["crew_status"] = getResult->getString("crew_status");
+        if (crewId > 0) {
+            aircraft["crew_id"] = crewId;
+            aircraft["crew_name"] = crewName;
+            aircraft["crew_status"] = crewStatus;
         } else {
             aircraft["crew_id"] = nullptr;
             aircraft["crew_name"] = nullptr;
             aircraft["crew_status"] = nullptr;
         }
 
-        aircraft["status"] = getResult->getString("status");
+        aircraft["status"] = status;
 
         json response;
         response["success"] = true;
@@ -385,6 +389,9 @@ crow::response AircraftController::createAircraft(const crow::request& req) {
 
         return crow::response(201, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in createAircraft: " + std::string(e.what()));
 
@@ -423,10 +430,13 @@ crow::response AircraftController::updateAircraft(const crow::request& req) {
         json requestData = json::parse(req.body);
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
-        // Check if aircraft exists
-        auto checkStmt = db->prepareStatement("SELECT * FROM aircraft WHERE aircraft_id = ?");
+        // Checks and update run in one transaction; it rolls back on any early return or error
+        auto transaction = db->beginTransaction();
+
+        // Check if aircraft exists, locking the row until the update is committed
+        auto checkStmt = db->prepareStatement("SELECT * FROM aircraft WHERE aircraft_id = ? FOR UPDATE");
         checkStmt->setInt(1, aircraftId);
         auto checkResult = db->executeQuery(checkStmt);
 
@@ -472,7 +482,8 @@ crow::response AircraftController::updateAircraft(const crow::request& req) {
 
         // If updating crew_id, validate crew
         if (crewId != currentCrewId && crewId > 0) {
-            auto crewStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
+            // Shared lock: the crew's members cannot change until the aircraft is saved
+            auto crewStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ? LOCK IN SHARE MODE");
             crewStmt->setInt(1, crewId);
             auto crewResult = db->executeQuery(crewStmt);
 
@@ -529,7 +540,7 @@ crow::response AircraftController::updateAircraft(const crow::request& req) {
 
         // Update aircraft
         std::string updateQuery;
-        std::unique_ptr<sql::PreparedStatement> updateStmt;
+        std::shared_ptr<sql::PreparedStatement> updateStmt;
 
         if (crewId > 0) {
             updateQuery = R"(
@@ -564,6 +575,8 @@ crow::response AircraftController::updateAircraft(const crow::request& req) {
 
         db->executeUpdate(updateStmt);
 
+        transaction.commit();
+
         // Get the updated aircraft
         auto getStmt = db->prepareStatement(R"(
             SELECT
@@ -611,6 +624,9 @@ crow::response AircraftController::updateAircraft(const crow::request& req) {
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in updateAircraft: " + std::string(e.what()));
 
@@ -645,7 +661,7 @@ crow::response AircraftController::deleteAircraft(const crow::request& req) {
         int aircraftId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
         // Check if aircraft exists
         auto checkStmt = db->prepareStatement("SELECT * FROM aircraft WHERE aircraft_id = ?");
@@ -687,6 +703,9 @@ crow::response AircraftController::deleteAircraft(const crow::request& req) {
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in deleteAircraft: " + std::string(e.what()));
 
@@ -712,7 +731,7 @@ crow::response AircraftController::getAircraftFlights(const crow::request& req)
         int aircraftId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
 
         // Check if aircraft exists
         auto checkStmt = db->prepareStatement("SELECT * FROM aircraft WHERE aircraft_id = ?");
@@ -754,41 +773,48 @@ crow::response AircraftController::getAircraftFlights(const crow::request& req)
             query += " AND f.status NOT IN ('canceled', 'arrived')";
         }
 
-        query += " ORDER BY f.departure_time";
+        query += " ORDER BY f.departure_time LIMIT ?";
 
         auto stmt = db->prepareStatement(query);
         stmt->setInt(1, aircraftId);
+        // One row past the cap tells whether the list was cut short
+        stmt->setInt(2, static_cast<int>(JsonStreamWriter::kMaxRows + 1));
 
-        auto result = db->executeQuery(stmt);
+        // Stream rows from the server instead of buffering the whole result in the driver
+        stmt->setFetchSize(256);
 
-        // Build response JSON
-        json flightsArray = json::array();
-
-        while (result->next()) {
-            json flight;
-            flight["flight_id"] = result->getInt("flight_id");
-            flight["flight_number"] = result->getString("flight_number");
-            flight["origin"] = result->getString("origin");
-            flight["destination"] = result->getString("destination");
-            flight["departure_time"] = result->getString("departure_time");
-            flight["arrival_time"] = result->getString("arrival_time");
-            flight["status"] = result->getString("status");
-            flight["gate"] = result->isNull("gate") ? nullptr : result->getString("gate");
-            if (result->isNull("base_price")) {
-                flight["base_price"] = nullptr;
-            } else {
-                flight["base_price"] = result->getDouble("base_price");
-            }
-
-            flightsArray.push_back(flight);
-        }
-
-        json response;
-        response["success"] = true;
-        response["count"] = flightsArray.size();
-        response["data"] = flightsArray;
+        auto result = db->executeQuery(stmt);
 
-        return crow::response(200, response.dump(4));
+        // Serialize rows straight into the response body; no json document is built
+        std::string body;
+        JsonStreamWriter writer(body);
+        writer.beginObject();
+        writer.key("success");
+        writer.value(true);
+        writer.key("data");
+        writer.beginArray();
+        size_t count = writer.writeRows(*result, {
+            {"flight_id", JsonStreamWriter::ColumnType::Int},
+            {"flight_number", JsonStreamWriter::ColumnType::String},
+            {"origin", JsonStreamWriter::ColumnType::String},
+            {"destination", JsonStreamWriter::ColumnType::String},
+            {"departure_time", JsonStreamWriter::ColumnType::String},
+            {"arrival_time", JsonStreamWriter::ColumnType::String},
+            {"status", JsonStreamWriter::ColumnType::String},
+            {"gate", JsonStreamWriter::ColumnType::String},
+            {"base_price", JsonStreamWriter::ColumnType::Double}
+        });
+        writer.endArray();
+        writer.key("count");
+        writer.value(static_cast<int64_t>(count));
+        writer.key("truncated");
+        writer.value(count == JsonStreamWriter::kMaxRows && result->next());
+        writer.endObject();
+
+        return crow::response(200, std::move(body));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
     }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getAircraftFlights: " + std::string(e.what()));
@@ -1,35 +1,43 @@
 #include "../../include/controllers/AuthController.h"
 #include "../../include/utils/Logger.h"
 #include "../../include/middleware/AuthMiddleware.h"
+#include "../../include/utils/DateFormat.h"
+#include "../../include/utils/TokenRevocationList.h"
 #include <nlohmann/json.hpp>
 #include <stdexcept>
-#include <sstream>
 #include <regex>
-#include <iomanip>
-#include <openssl/sha.h>
 
 using json = nlohmann::json;
 
-// Simple password hashing using SHA-256 for now
-// In a production system, use a more secure hashing algorithm with salt like bcrypt
+// PBKDF2 on the password hasher's own threads; see PasswordHasher
 std::string AuthController::hashPassword(const std::string& password) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, password.c_str(), password.length());
-    SHA256_Final(hash, &sha256);
-
-    std::stringstream ss;
-    for(int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-    }
-    return ss.str();
+    return PasswordHasher::getInstance().hash(password);
 }
 
 bool AuthController::verifyPassword(const std::string& providedPassword, const std::string& storedHash) {
-    // For now, the JavaScript API is using plaintext passwords as noted in the code
-    // So we'll match that behavior, but in production this should be a secure comparison
-    return providedPassword == storedHash;
+    return PasswordHasher::getInstance().verify(providedPassword, storedHash).valid;
+}
+
+void AuthController::upgradePasswordHash(int userId, const std::string& password) {
+    // Best effort and off the request path: the login already succeeded, and the next one will try again
+    auto upgrade = [userId, password]() {
+        try {
+            std::string passwordHash = PasswordHasher::getInstance().hashNow(password);
+
+            auto db = DBConnectionPool::getInstance().getWriteConnection(userId);
+            auto stmt = db->prepareStatement("UPDATE users SET password = ? WHERE user_id = ?");
+            stmt->setString(1, passwordHash);
+            stmt->setInt(2, userId);
+            db->executeUpdate(stmt);
+        }
+        catch (const std::exception& e) {
+            LOG_WARNING("Could not upgrade password hash for user " + std::to_string(userId) + ": " + e.what());
+        }
+    };
+
+    if (!PasswordHasher::getInstance().runWhenIdle(upgrade)) {
+        LOG_DEBUG("Password hash upgrade for user " + std::to_string(userId) + " skipped: hasher busy");
+    }
 }
 
 crow::response AuthController::createTokenResponse(int userId, const std::string& role, const nlohmann::json& userData) {
@@ -55,6 +63,16 @@ crow::response AuthController::createTokenResponse(int userId, const std::string
     }
 }
 
+crow::response AuthController::createHasherBusyResponse(const PasswordHasherBusyError& e) {
+    json error;
+    error["success"] = false;
+    error["error"] = "Too many sign-in attempts in progress, please retry shortly";
+
+    crow::response res(429, error.dump(4));
+    res.set_header("Retry-After", "1");
+    return res;
+}
+
 crow::response AuthController::registerEmail(const crow::request& req) {
     try {
         // Parse request body
@@ -82,6 +100,9 @@ crow::response AuthController::registerEmail(const crow::request& req) {
             return crow::response(400, error.dump(4));
         }
 
+        // Hash first so the key derivation does not hold a pooled connection
+        std::string passwordHash = hashPassword(password);
+
         // Get database connection
         auto db = DBConnectionPool::getInstance().getConnection();
 
@@ -97,43 +118,26 @@ crow::response AuthController::registerEmail(const crow::request& req) {
             return crow::response(400, error.dump(4));
         }
 
-        // Create user
-        auto insertStmt = db->prepareStatement(
-            "INSERT INTO users (first_name, email, password, role) VALUES (?, ?, ?, ?)"
+        // Create user; created_at is set here so the response needs no read-back
+        std::string createdAt = DateFormat::formatMySQLDateTime(std::chrono::system_clock::now());
+        auto insertStmt = db->prepareInsert(
+            "INSERT INTO users (first_name, email, password, role, created_at) VALUES (?, ?, ?, ?, ?)"
         );
         insertStmt->setString(1, name);
         insertStmt->setString(2, email);
-        insertStmt->setString(3, password); // plaintext to match JS API behavior
+        insertStmt->setString(3, passwordHash);
         insertStmt->setString(4, role);
+        insertStmt->setString(5, createdAt);
 
-        db->executeUpdate(insertStmt);
-        // Get the last insert ID
-        auto idStmt = db->prepareStatement("SELECT LAST_INSERT_ID()");
-        auto idResult = db->executeQuery(idStmt);
-        idResult->next();
-        int userId = idResult->getInt(1);
-
-        // Get created user
-        auto userStmt = db->prepareStatement(
-            "SELECT user_id, first_name, email, role, created_at FROM users WHERE user_id = ?"
-        );
-        userStmt->setInt(1, userId);
-        auto userResult = db->executeQuery(userStmt);
-
-        if (!userResult->next()) {
-            json error;
-            error["success"] = false;
-            error["error"] = "Error retrieving user data";
-            return crow::response(500, error.dump(4));
-        }
+        int userId = static_cast<int>(db->executeInsert(insertStmt));
 
         // Create user data JSON
         json userData;
-        userData["user_id"] = userResult->getInt("user_id");
-        userData["first_name"] = userResult->getString("first_name");
-        userData["email"] = userResult->getString("email");
-        userData["role"] = userResult->getString("role");
-        userData["created_at"] = userResult->getString("created_at");
+        userData["user_id"] = userId;
+        userData["first_name"] = name;
+        userData["email"] = email;
+        userData["role"] = role;
+        userData["created_at"] = createdAt;
 
         // Create token response
         return createTokenResponse(userId, role, userData);
@@ -147,6 +151,12 @@ crow::response AuthController::registerEmail(const crow::request& req) {
 
         return crow::response(400, error.dump(4));
     }
+    catch (const PasswordHasherBusyError& e) {
+        return createHasherBusyResponse(e);
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in registerEmail: " + std::string(e.what()));
 
@@ -185,6 +195,9 @@ crow::response AuthController::registerPhone(const crow::request& req) {
         std::string password = requestData["password"];
         std::string role = requestData.contains("role") ? requestData["role"] : "user";
 
+        // Hash first so the key derivation does not hold a pooled connection
+        std::string passwordHash = hashPassword(password);
+
         // Get database connection
         auto db = DBConnectionPool::getInstance().getConnection();
 
@@ -200,43 +213,26 @@ crow::response AuthController::registerPhone(const crow::request& req) {
             return crow::response(400, error.dump(4));
         }
 
-        // Create user
-        auto insertStmt = db->prepareStatement(
-            "INSERT INTO users (first_name, contact_number, password, role) VALUES (?, ?, ?, ?)"
+        // Create user; created_at is set here so the response needs no read-back
+        std::string createdAt = DateFormat::formatMySQLDateTime(std::chrono::system_clock::now());
+        auto insertStmt = db->prepareInsert(
+            "INSERT INTO users (first_name, contact_number, password, role, created_at) VALUES (?, ?, ?, ?, ?)"
         );
         insertStmt->setString(1, name);
         insertStmt->setString(2, phone);
-        insertStmt->setString(3, password); // plaintext to match JS API behavior
+        insertStmt->setString(3, passwordHash);
         insertStmt->setString(4, role);
+        insertStmt->setString(5, createdAt);
 
-        db->executeUpdate(insertStmt);
-        // Get the last insert ID
-        auto idStmt = db->prepareStatement("SELECT LAST_INSERT_ID()");
-        auto idResult = db->executeQuery(idStmt);
-        idResult->next();
-        int userId = idResult->getInt(1);
-
-        // Get created user
-        auto userStmt = db->prepareStatement(
-            "SELECT user_id, first_name, contact_number, role, created_at FROM users WHERE user_id = ?"
-        );
-        userStmt->setInt(1, userId);
-        auto userResult = db->executeQuery(userStmt);
-
-        if (!userResult->next()) {
-            json error;
-            error["success"] = false;
-            error["error"] = "Error retrieving user data";
-            return crow::response(500, error.dump(4));
-        }
+        int userId = static_cast<int>(db->executeInsert(insertStmt));
 
         // Create user data JSON
         json userData;
-        userData["user_id"] = userResult->getInt("user_id");
-        userData["first_name"] = userResult->getString("first_name");
-        userData["contact_number"] = userResult->getString("contact_number");
-        userData["role"] = userResult->getString("role");
-        userData["created_at"] = userResult->getString("created_at");
+        userData["user_id"] = userId;
+        userData["first_name"] = name;
+        userData["contact_number"] = phone;
+        userData["role"] = role;
+        userData["created_at"] = createdAt;
 
         // Create token response
         return createTokenResponse(userId, role, userData);
@@ -250,6 +246,12 @@ crow::response AuthController::registerPhone(const crow::request& req) {
 
         return crow::response(400, error.dump(4));
     }
+    catch (const PasswordHasherBusyError& e) {
+        return createHasherBusyResponse(e);
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in registerPhone: " + std::string(e.what()));
 
@@ -286,45 +288,60 @@ crow::response AuthController::login(const crow::request& req) {
         std::string email = requestData["email"];
         std::string password = requestData["password"];
 
-        // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        // Look the user up, then check the password off the connection
+        int userId = 0;
+        std::string storedPassword;
+        json userData;
+        {
+            auto db = DBConnectionPool::getInstance().getConnection();
+
+            auto stmt = db->prepareStatement(
+                "SELECT user_id, first_name, last_name, email, role, created_at, password FROM users WHERE email = ?"
+            );
+            stmt->setString(1, email);
+            auto result = db->executeQuery(stmt);
+
+            if (result->next()) {
+                userId = result->getInt("user_id");
+                storedPassword = result->getString("password").c_str();
+
+                userData["user_id"] = userId;
+                userData["first_name"] = result->getString("first_name");
+                userData["email"] = result->getString("email");
+                userData["role"] = result->getString("role");
+
+                if (!result->isNull("last_name")) {
+                    userData["last_name"] = result->getString("last_name");
+                }
+                if (!result->isNull("created_at")) {
+                    userData["created_at"] = result->getString("created_at");
+                }
+            }
+        }
 
-        // Check for user with direct password comparison (matching JS API behavior)
-        auto stmt = db->prepareStatement(
-            "SELECT * FROM users WHERE email = ? AND password = ?"
-        );
-        stmt->setString(1, email);
-        stmt->setString(2, password);
-        auto result = db->executeQuery(stmt);
+        if (userId == 0) {
+            // Spend the same work as a real check, so response time does not reveal which accounts exist
+            hashPassword(password);
+        }
 
-        if (!result->next()) {
+        auto verification = userId != 0
+            ? PasswordHasher::getInstance().verify(password, storedPassword)
+            : PasswordHasher::Verification{false, false};
+
+        if (!verification.valid) {
             json error;
             error["success"] = false;
             error["error"] = "Invalid credentials";
             return crow::response(401, error.dump(4));
         }
 
-        // Get user data
-        int userId = result->getInt("user_id");
-        std::string role = static_cast<std::string>(result->getString("role"));
-
-        // Create user data JSON
-        json userData;
-        userData["user_id"] = userId;
-        userData["first_name"] = result->getString("first_name");
-        userData["email"] = result->getString("email");
-        userData["role"] = role;
-
-        if (result->getMetaData()->getColumnCount() > 4) {
-            // Add optional fields if they exist
-            if (result->findColumn("last_name") != 0) {
-                userData["last_name"] = result->getString("last_name");
-            }
-            if (result->findColumn("created_at") != 0) {
-                userData["created_at"] = result->getString("created_at");
-            }
+        // Plaintext from before hashing, or an older work factor
+        if (verification.needsRehash) {
+            upgradePasswordHash(userId, password);
         }
 
+        std::string role = userData["role"].get<std::string>();
+
         // Create token response
         return createTokenResponse(userId, role, userData);
     }
@@ -337,6 +354,12 @@ crow::response AuthController::login(const crow::request& req) {
 
         return crow::response(400, error.dump(4));
     }
+    catch (const PasswordHasherBusyError& e) {
+        return createHasherBusyResponse(e);
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in login: " + std::string(e.what()));
 
@@ -373,45 +396,60 @@ crow::response AuthController::loginPhone(const crow::request& req) {
         std::string phone = requestData["phone"];
         std::string password = requestData["password"];
 
-        // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        // Look the user up, then check the password off the connection
+        int userId = 0;
+        std::string storedPassword;
+        json userData;
+        {
+            auto db = DBConnectionPool::getInstance().getConnection();
+
+            auto stmt = db->prepareStatement(
+                "SELECT user_id, first_name, last_name, contact_number, role, created_at, password FROM users WHERE contact_number = ?"
+            );
+            stmt->setString(1, phone);
+            auto result = db->executeQuery(stmt);
+
+            if (result->next()) {
+                userId = result->getInt("user_id");
+                storedPassword = result->getString("password").c_str();
+
+                userData["user_id"] = userId;
+                userData["first_name"] = result->getString("first_name");
+                userData["contact_number"] = result->getString("contact_number");
+                userData["role"] = result->getString("role");
+
+                if (!result->isNull("last_name")) {
+                    userData["last_name"] = result->getString("last_name");
+                }
+                if (!result->isNull("created_at")) {
+                    userData["created_at"] = result->getString("created_at");
+                }
+            }
+        }
 
-        // Check for user with direct password comparison (matching JS API behavior)
-        auto stmt = db->prepareStatement(
-            "SELECT * FROM users WHERE contact_number = ? AND password = ?"
-        );
-        stmt->setString(1, phone);
-        stmt->setString(2, password);
-        auto result = db->executeQuery(stmt);
+        if (userId == 0) {
+            // Spend the same work as a real check, so response time does not reveal which accounts exist
+            hashPassword(password);
+        }
 
-        if (!result->next()) {
+        auto verification = userId != 0
+            ? PasswordHasher::getInstance().verify(password, storedPassword)
+            : PasswordHasher::Verification{false, false};
+
+        if (!verification.valid) {
             json error;
             error["success"] = false;
             error["error"] = "Invalid credentials";
             return crow::response(401, error.dump(4));
         }
 
-        // Get user data
-        int userId = result->getInt("user_id");
-        std::string role = result->getString("role").c_str();
-
-        // Create user data JSON
-        json userData;
-        userData["user_id"] = userId;
-        userData["first_name"] = result->getString("first_name");
-        userData["contact_number"] = result->getString("contact_number");
-        userData["role"] = role;
-
-        if (result->getMetaData()->getColumnCount() > 4) {
-            // Add optional fields if they exist
-            if (result->findColumn("last_name") != 0) {
-                userData["last_name"] = result->getString("last_name");
-            }
-            if (result->findColumn("created_at") != 0) {
-                userData["created_at"] = result->getString("created_at");
-            }
+        // Plaintext from before hashing, or an older work factor
+        if (verification.needsRehash) {
+            upgradePasswordHash(userId, password);
         }
 
+        std::string role = userData["role"].get<std::string>();
+
         // Create token response
         return createTokenResponse(userId, role, userData);
     }
@@ -424,6 +462,12 @@ crow::response AuthController::loginPhone(const crow::request& req) {
 
         return crow::response(400, error.dump(4));
     }
+    catch (const PasswordHasherBusyError& e) {
+        return createHasherBusyResponse(e);
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in loginPhone: " + std::string(e.what()));
 
@@ -450,7 +494,7 @@ crow::response AuthController::getMe(const crow::request& req) {
         int userId = get_user_id(req);
 
         // Get database connection to fetch latest user data
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getReadConnection(userId);
 
         // Get user data from database
         auto stmt = db->prepareStatement(
@@ -503,6 +547,9 @@ crow::response AuthController::getMe(const crow::request& req) {
 
         return crow::response(400, error.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getMe: " + std::string(e.what()));
 
@@ -542,34 +589,46 @@ crow::response AuthController::updatePassword(const crow::request& req) {
 
         int userId = get_user_id(req);
 
-        // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        // Read the stored hash, then check it off the connection
+        std::string storedPassword;
+        std::string role;
+        {
+            auto db = DBConnectionPool::getInstance().getWriteConnection(userId);
 
-        // Check current password
-        auto stmt = db->prepareStatement(
-            "SELECT * FROM users WHERE user_id = ? AND password = ?"
-        );
-        stmt->setInt(1, userId);
-        stmt->setString(2, currentPassword);
-        auto result = db->executeQuery(stmt);
+            auto stmt = db->prepareStatement("SELECT password, role FROM users WHERE user_id = ?");
+            stmt->setInt(1, userId);
+            auto result = db->executeQuery(stmt);
 
-        if (!result->next()) {
+            if (result->next()) {
+                storedPassword = result->getString("password").c_str();
+                role = result->getString("role").c_str();
+            }
+        }
+
+        if (role.empty() || !verifyPassword(currentPassword, storedPassword)) {
             json error;
             error["success"] = false;
             error["error"] = "Current password is incorrect";
             return crow::response(401, error.dump(4));
         }
 
+        std::string passwordHash = hashPassword(newPassword);
+
         // Update password
+        auto db = DBConnectionPool::getInstance().getWriteConnection(userId);
         auto updateStmt = db->prepareStatement(
             "UPDATE users SET password = ? WHERE user_id = ?"
         );
-        updateStmt->setString(1, newPassword);
+        updateStmt->setString(1, passwordHash);
         updateStmt->setInt(2, userId);
         db->executeUpdate(updateStmt);
+        UserStatusCache::getInstance().invalidate(userId);
+
+        // Sign out every other session: tokens issued before now are rejected until they would have expired
+        TokenRevocationList::getInstance().revokeUser(
+            userId, std::chrono::system_clock::now() + std::chrono::seconds(JWTUtils::getInstance().getExpiresIn()));
 
         // Generate new token
-        std::string role = result->getString("role").c_str();
         std::string token = JWTUtils::getInstance().generateToken(userId, role);
 
         // Create response
@@ -589,6 +648,12 @@ crow::response AuthController::updatePassword(const crow::request& req) {
 
         return crow::response(400, error.dump(4));
     }
+    catch (const PasswordHasherBusyError& e) {
+        return createHasherBusyResponse(e);
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in updatePassword: " + std::string(e.what()));
 
@@ -610,11 +675,35 @@ crow::response AuthController::updatePassword(const crow::request& req) {
 }
 
 crow::response AuthController::logout(const crow::request& req) {
-    // In this implementation, we don't need to do anything on the server side
-    // for logout since we're using JWT. The client should just remove the token.
-    json response;
-    response["success"] = true;
-    response["data"] = json::object();
+    try {
+        auto userData = get_user_data(req);
+        auto& revocations = TokenRevocationList::getInstance();
+
+        // Revoke this token until it expires on its own
+        if (userData.count("jti") && userData.count("exp")) {
+            revocations.revokeToken(
+                userData["jti"],
+                std::chrono::system_clock::time_point(std::chrono::seconds(std::stoll(userData["exp"]))));
+        } else {
+            // Tokens issued before they carried an id can only be revoked together with the user's others
+            revocations.revokeUser(
+                get_user_id(req),
+                std::chrono::system_clock::now() + std::chrono::seconds(JWTUtils::getInstance().getExpiresIn()));
+        }
 
-    return crow::response(200, response.dump(4));
+        json response;
+        response["success"] = true;
+        response["data"] = json::object();
+
+        return crow::response(200, response.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in logout: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
 }
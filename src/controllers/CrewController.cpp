@@ -1,6 +1,21 @@
 #include "../../include/controllers/CrewController.h"
 #include <stdexcept>
 #include <sstream>
+#include <unordered_map>
+
+namespace {
+    // Bulk requests are capped so one request cannot hold the crew lock for long
+    const size_t kMaxBulkItems = 1000;
+
+    json bulkItemError(size_t index, int status, const std::string& message) {
+        json item;
+        item["index"] = index;
+        item["status"] = status;
+        item["success"] = false;
+        item["error"] = message;
+        return item;
+    }
+}
 
 crow::response CrewController::getCrews(const crow::request& req) {
     try {
@@ -24,9 +39,6 @@ crow::response CrewController::getCrews(const crow::request& req) {
         // Calculate offset
         int offset = (page - 1) * limit;
 
-        // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
-
         // Build query with status filter if needed
         std::stringstream queryStream;
         queryStream << R"(
@@ -48,18 +60,6 @@ crow::response CrewController::getCrews(const crow::request& req) {
             LIMIT ? OFFSET ?
         )";
 
-        std::string query = queryStream.str();
-        auto stmt = db->prepareStatement(query);
-
-        int paramIndex = 1;
-        if (!status.empty()) {
-            stmt->setString(paramIndex++, status);
-        }
-        stmt->setInt(paramIndex++, limit);
-        stmt->setInt(paramIndex, offset);
-
-        auto result = db->executeQuery(stmt);
-
         // Build count query with the same filter
         std::stringstream countQueryStream;
         countQueryStream << "SELECT COUNT(*) as count FROM crews";
@@ -68,15 +68,36 @@ crow::response CrewController::getCrews(const crow::request& req) {
             countQueryStream << " WHERE status = ?";
         }
 
-        auto countStmt = db->prepareStatement(countQueryStream.str());
+        // Fetch the total count and the page in one round trip
+        QueryBatch queries;
+        queries.add(countQueryStream.str());
+        if (!status.empty()) {
+            queries.bind(status);
+        }
+
+        queries.add(queryStream.str());
         if (!status.empty()) {
-            countStmt->setString(1, status);
+            queries.bind(status);
         }
+        queries.bind(limit).bind(offset);
 
-        auto countResult = db->executeQuery(countStmt);
+        // Served from the result cache while none of the tables it reads were written
+        auto cached = QueryCache::getInstance().lookup(queries.render(), {"crews", "crew_assignments", "aircraft"});
+        if (cached) {
+            return crow::response(200, *cached);
+        }
+
+        // Get database connection
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
+
+        auto batch = db->executeBatch(queries);
+
+        auto countResult = batch.next();
         countResult->next();
         int totalCount = countResult->getInt("count");
 
+        auto result = batch.next();
+
         // Build response JSON
         json response;
         json crewsArray = json::array();
@@ -102,7 +123,16 @@ crow::response CrewController::getCrews(const crow::request& req) {
         };
         response["data"] = crewsArray;
 
-        return crow::response(200, response.dump(4));
+        // A replica may not have the latest writes yet; only a primary read is safe to keep as current
+        std::string body = response.dump(4);
+        if (db.isPrimary()) {
+            QueryCache::getInstance().store(cached, body);
+        }
+
+        return crow::response(200, body);
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
     }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getCrews: " + std::string(e.what()));
@@ -129,7 +159,7 @@ crow::response CrewController::getCrew(const crow::request& req) {
         int crewId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
 
         // Get crew details
         std::string query = R"(
@@ -169,6 +199,9 @@ crow::response CrewController::getCrew(const crow::request& req) {
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getCrew: " + std::string(e.what()));
 
@@ -206,41 +239,21 @@ crow::response CrewController::createCrew(const crow::request& req) {
         std::string status = requestData.contains("status") ? requestData["status"].get<std::string>() : "active";
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
         // Create crew
         std::string query = "INSERT INTO crews (name, status) VALUES (?, ?)";
-        auto stmt = db->prepareStatement(query);
+        auto stmt = db->prepareInsert(query);
         stmt->setString(1, name);
         stmt->setString(2, status);
 
-        db->executeUpdate(stmt);
+        int crewId = static_cast<int>(db->executeInsert(stmt));
 
-        // Get the last insert ID
-        auto idStmt = db->prepareStatement("SELECT LAST_INSERT_ID()");
-        auto idResult = db->executeQuery(idStmt);
-        idResult->next();
-        int crewId = idResult->getInt(1);
-
-        // Get the created crew
-        auto getStmt = db->prepareStatement(R"(
-            SELECT
-                crew_id,
-                name,
-                status
-            FROM crews
-            WHERE crew_id = ?
-        )");
-        getStmt->setInt(1, crewId);
-        auto getResult = db->executeQuery(getStmt);
-
-        getResult->next();
-
-        // Build response JSON
+        // Build response JSON from the inserted values; no read-back is needed
         json crew;
-        crew["crew_id"] = getResult->getInt("crew_id");
-        crew["name"] = getResult->getString("name");
-        crew["status"] = getResult->getString("status");
+        crew["crew_id"] = crewId;
+        crew["name"] = name;
+        crew["status"] = status;
         crew["member_count"] = 0; // New crew has no members yet
         crew["aircraft_count"] = 0; // New crew has no aircraft yet
 
@@ -250,6 +263,9 @@ crow::response CrewController::createCrew(const crow::request& req) {
 
         return crow::response(201, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in createCrew: " + std::string(e.what()));
 
@@ -287,7 +303,7 @@ crow::response CrewController::updateCrew(const crow::request& req) {
         json requestData = json::parse(req.body);
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
         // Check if crew exists
         auto checkStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
@@ -353,6 +369,9 @@ crow::response CrewController::updateCrew(const crow::request& req) {
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in updateCrew: " + std::string(e.what()));
 
@@ -387,10 +406,13 @@ crow::response CrewController::deleteCrew(const crow::request& req) {
         int crewId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
-        // Check if crew exists
-        auto checkStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
+        // Checks and deletes run in one transaction; it rolls back on any early return or error
+        auto transaction = db->beginTransaction();
+
+        // Check if crew exists, locking it so no aircraft or member can be attached meanwhile
+        auto checkStmt = db->prepareStatement("SELECT crew_id FROM crews WHERE crew_id = ? FOR UPDATE");
         checkStmt->setInt(1, crewId);
         auto checkResult = db->executeQuery(checkStmt);
 
@@ -414,34 +436,26 @@ crow::response CrewController::deleteCrew(const crow::request& req) {
             return crow::response(400, error.dump(4));
         }
 
-        // Start transaction
-        db->getConnection()->setAutoCommit(false);
-
-        try {
-            // Delete crew assignments first
-            auto deleteAssignmentsStmt = db->prepareStatement("DELETE FROM crew_assignments WHERE crew_id = ?");
-            deleteAssignmentsStmt->setInt(1, crewId);
-            db->executeUpdate(deleteAssignmentsStmt);
+        // Delete crew assignments first
+        auto deleteAssignmentsStmt = db->prepareStatement("DELETE FROM crew_assignments WHERE crew_id = ?");
+        deleteAssignmentsStmt->setInt(1, crewId);
+        db->executeUpdate(deleteAssignmentsStmt);
 
-            // Delete the crew
-            auto deleteCrewStmt = db->prepareStatement("DELETE FROM crews WHERE crew_id = ?");
-            deleteCrewStmt->setInt(1, crewId);
-            db->executeUpdate(deleteCrewStmt);
+        // Delete the crew
+        auto deleteCrewStmt = db->prepareStatement("DELETE FROM crews WHERE crew_id = ?");
+        deleteCrewStmt->setInt(1, crewId);
+        db->executeUpdate(deleteCrewStmt);
 
-            // Commit transaction
-            db->getConnection()->commit();
+        transaction.commit();
 
-            json response;
-            response["success"] = true;
-            response["data"] = json::object();
+        json response;
+        response["success"] = true;
+        response["data"] = json::object();
 
-            return crow::response(200, response.dump(4));
-        }
-        catch (const std::exception& e) {
-            // Rollback on error
-            db->getConnection()->rollback();
-            throw;
-        }
+        return crow::response(200, response.dump(4));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
     }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in deleteCrew: " + std::string(e.what()));
@@ -468,19 +482,7 @@ crow::response CrewController::getCrewMembers(const crow::request& req) {
         int crewId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
-
-        // Check if crew exists
-        auto checkStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
-        checkStmt->setInt(1, crewId);
-        auto checkResult = db->executeQuery(checkStmt);
-
-        if (!checkResult->next()) {
-            json error;
-            error["success"] = false;
-            error["error"] = "Crew not found with id of " + std::to_string(crewId);
-            return crow::response(404, error.dump(4));
-        }
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
 
         // Get crew members
         std::string query = R"(
@@ -492,29 +494,38 @@ crow::response CrewController::getCrewMembers(const crow::request& req) {
                 cm.license_number,
                 cm.experience_years
             FROM crew_members cm
-            JOIN crew_assignments ca ON cm.crew_member_id = ca.crew_member_id
-            WHERE ca.crew_id = ?
-            ORDER BY cm.role, cm.last_name, cm.first_name
+JOIN crew_assignments ca ON cm.crew_member_id = ca.crew_member_id
+WHERE ca.crew_id = ?
+ORDER BY cm.role, cm.last_name, cm.first_name
         )";
 
-        auto stmt = db->prepareStatement(query);
-        stmt->setInt(1, crewId);
+        // Check the crew exists and run the main query in one round trip
+        auto batch = db->executeBatch(QueryBatch()
+.add("SELECT crew_id FROM crews WHERE crew_id = ?").bind(crewId)
+.add(query).bind(crewId));
 
-        auto result = db->executeQuery(stmt);
+        if (!batch.next()->next()) {
+json error;
+error["success"] = false;
+error["error"] = "Crew not found with id of " + std::to_string(crewId);
+return crow::response(404, error.dump(4));
+        }
+
+        auto result = batch.next();
 
         // Build response JSON
         json crewMembersArray = json::array();
 
         while (result->next()) {
-            json crewMember;
-            crewMember["crew_member_id"] = result->getInt("crew_member_id");
-            crewMember["first_name"] = result->getString("first_name");
-            crewMember["last_name"] = result->getString("last_name");
-            crewMember["role"] = result->getString("role");
-            crewMember["license_number"] = result->isNull("license_number") ? nullptr : result->getString("license_number");
-            crewMember["experience_years"] = result->getInt("experience_years");
-
-            crewMembersArray.push_back(crewMember);
+json crewMember;
+crewMember["crew_member_id"] = result->getInt("crew_member_id");
+crewMember["first_name"] = result->getString("first_name");
+crewMember["last_name"] = result->getString("last_name");
+crewMember["role"] = result->getString("role");
+crewMember["license_number"] = result->isNull("license_number") ? nullptr : result->getString("license_number");
+crewMember["experience_years"] = result->getInt("experience_years");
+
+crewMembersArray.push_back(crewMember);
         }
 
         json response;
@@ -524,6 +535,9 @@ crow::response CrewController::getCrewMembers(const crow::request& req) {
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getCrewMembers: " + std::string(e.what()));
 
@@ -553,27 +567,30 @@ crow::response CrewController::assignCrewMember(const crow::request& req) {
 
         // Validate required fields
         if (!requestData.contains("crew_member_id")) {
-            json error;
-            error["success"] = false;
-            error["error"] = "Please provide crew_member_id";
-            return crow::response(400, error.dump(4));
+json error;
+error["success"] = false;
+error["error"] = "Please provide crew_member_id";
+return crow::response(400, error.dump(4));
         }
 
         int crewMemberId = requestData["crew_member_id"];
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
-        // Check if crew exists
-        auto checkCrewStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
+        // Checks and insert run in one transaction; it rolls back on any early return or error
+        auto transaction = db->beginTransaction();
+
+        // Check if crew exists, locking it so concurrent changes to its members are serialized
+        auto checkCrewStmt = db->prepareStatement("SELECT crew_id FROM crews WHERE crew_id = ? FOR UPDATE");
         checkCrewStmt->setInt(1, crewId);
         auto checkCrewResult = db->executeQuery(checkCrewStmt);
 
         if (!checkCrewResult->next()) {
-            json error;
-            error["success"] = false;
-            error["error"] = "Crew not found with id of " + std::to_string(crewId);
-            return crow::response(404, error.dump(4));
+json error;
+error["success"] = false;
+error["error"] = "Crew not found with id of " + std::to_string(crewId);
+return crow::response(404, error.dump(4));
         }
 
         // Check if crew member exists
@@ -582,15 +599,15 @@ crow::response CrewController::assignCrewMember(const crow::request& req) {
         auto checkMemberResult = db->executeQuery(checkMemberStmt);
 
         if (!checkMemberResult->next()) {
-            json error;
-            error["success"] = false;
-            error["error"] = "Crew member not found with id of " + std::to_string(crewMemberId);
-            return crow::response(404, error.dump(4));
+json error;
+error["success"] = false;
+error["error"] = "Crew member not found with id of " + std::to_string(crewMemberId);
+return crow::response(404, error.dump(4));
         }
 
         // Check if assignment already exists
         auto checkAssignmentStmt = db->prepareStatement(
-            "SELECT COUNT(*) AS count FROM crew_assignments WHERE crew_id = ? AND crew_member_id = ?"
+"SELECT COUNT(*) AS count FROM crew_assignments WHERE crew_id = ? AND crew_member_id = ?"
         );
         checkAssignmentStmt->setInt(1, crewId);
         checkAssignmentStmt->setInt(2, crewMemberId);
@@ -598,20 +615,348 @@ crow::response CrewController::assignCrewMember(const crow::request& req) {
 
         checkAssignmentResult->next();
         if (checkAssignmentResult->getInt("count") > 0) {
-            json error;
-            error["success"] = false;
-            error["error"] = "Crew member is already assigned to this crew";
-            return crow::response(400, error.dump(4));
+json error;
+error["success"] = false;
+error["error"] = "Crew member is already assigned to this crew";
+return crow::response(400, error.dump(4));
         }
 
         // Create assignment
         auto assignStmt = db->prepareStatement(
-            "INSERT INTO crew_assignments (crew_id, crew_member_id) VALUES (?, ?)"
+"INSERT INTO crew_assignments (crew_id, crew_member_id) VALUES (?, ?)"
         );
         assignStmt->setInt(1, crewId);
         assignStmt->setInt(2, crewMemberId);
         db->executeUpdate(assignStmt);
 
+        transaction.commit();
+
+        // Get updated crew members
+        auto membersStmt = db->prepareStatement(R"(
+SELECT
+    cm.crew_member_id,
+    cm.first_name,
+    cm.last_name,
+    cm.role,
+    cm.license_number,
+    cm.experience_years
+FROM crew_members cm
+            JOIN crew_assignments ca ON cm.crew_member_id = ca.crew_member_id
+            WHERE ca.crew_id = ?
+            ORDER BY cm.role, cm.last_name, cm.first_name
+        )");
+        membersStmt->setInt(1, crewId);
+
+        auto membersResult = db->executeQuery(membersStmt);
+
+        // Build response JSON
+        json crewMembersArray = json::array();
+
+        while (membersResult->next()) {
+            json crewMember;
+            crewMember["crew_member_id"] = membersResult->getInt("crew_member_id");
+            crewMember["first_name"] = membersResult->getString("first_name");
+            crewMember["last_name"] = membersResult->getString("last_name");
+            crewMember["role"] = membersResult->getString("role");
+            crewMember["license_number"] = membersResult->isNull("license_number") ? nullptr : membersResult->getString("license_number");
+            crewMember["experience_years"] = membersResult->getInt("experience_years");
+
+            crewMembersArray.push_back(crewMember);
+        }
+
+        json response;
+        response["success"] = true;
+        response["count"] = crewMembersArray.size();
+        response["data"] = crewMembersArray;
+
+        return crow::response(200, response.dump(4));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("SQL error in assignCrewMember: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = "Database error";
+
+        return crow::response(500, error.dump(4));
+    }
+    catch (const json::exception& e) {
+        LOG_ERROR("JSON parsing error: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = "Invalid JSON format";
+
+        return crow::response(400, error.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in assignCrewMember: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
+
+crow::response CrewController::assignCrewMembersBulk(const crow::request& req) {
+    try {
+        int crewId = std::stoi(req.url_params.get("id"));
+
+        // Parse request body: a bare array of ids or {"crew_member_ids": [...]}
+        json requestData = json::parse(req.body);
+        json items = requestData.is_object() && requestData.contains("crew_member_ids") ?
+                     requestData["crew_member_ids"] : requestData;
+
+        if (!items.is_array() || items.empty()) {
+            json error;
+            error["success"] = false;
+            error["error"] = "Please provide an array of crew_member_ids";
+            return crow::response(400, error.dump(4));
+        }
+
+        if (items.size() > kMaxBulkItems) {
+            json error;
+            error["success"] = false;
+            error["error"] = "At most " + std::to_string(kMaxBulkItems) + " crew members per request";
+            return crow::response(400, error.dump(4));
+        }
+
+        std::vector<json> results(items.size());
+        std::unordered_map<int, size_t> memberItems; // crew member id -> item index
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (!items[i].is_number_integer()) {
+                results[i] = bulkItemError(i, 400, "crew_member_id must be an integer");
+            } else if (!memberItems.emplace(items[i].get<int>(), i).second) {
+                results[i] = bulkItemError(i, 400, "Duplicate crew member in request");
+            }
+        }
+
+        // Get database connection
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
+
+        // Checks and inserts run in one transaction; it rolls back on any early return or error
+        auto transaction = db->beginTransaction();
+
+        // Check if crew exists, locking it so concurrent changes to its members are serialized
+        auto checkCrewStmt = db->prepareStatement("SELECT crew_id FROM crews WHERE crew_id = ? FOR UPDATE");
+        checkCrewStmt->setInt(1, crewId);
+        auto checkCrewResult = db->executeQuery(checkCrewStmt);
+
+        if (!checkCrewResult->next()) {
+            json error;
+            error["success"] = false;
+            error["error"] = "Crew not found with id of " + std::to_string(crewId);
+            return crow::response(404, error.dump(4));
+        }
+
+        // Existence and current assignment of every requested member in one query
+        std::unordered_map<int, bool> found; // crew member id -> already assigned to this crew
+
+        if (!memberItems.empty()) {
+            std::string placeholders;
+            for (size_t i = 0; i < memberItems.size(); ++i) {
+                placeholders += i > 0 ? ", ?" : "?";
+            }
+
+            QueryBatch batch;
+            batch.add(R"(
+                SELECT cm.crew_member_id, COUNT(ca.crew_id) AS assigned
+                FROM crew_members cm
+                LEFT JOIN crew_assignments ca ON ca.crew_member_id = cm.crew_member_id AND ca.crew_id = ?
+                WHERE cm.crew_member_id IN ()" + placeholders + R"()
+                GROUP BY cm.crew_member_id
+            )");
+            batch.bind(crewId);
+            for (const auto& [memberId, index] : memberItems) {
+                batch.bind(memberId);
+            }
+
+            auto checkResults = db->executeBatch(batch);
+            auto members = checkResults.next();
+            while (members->next()) {
+                found[members->getInt("crew_member_id")] = members->getInt("assigned") > 0;
+            }
+        }
+
+        BulkInsert insert("crew_assignments", {"crew_id", "crew_member_id"});
+        std::vector<size_t> rowItems;
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (!results[i].is_null()) {
+                continue;
+            }
+
+            int memberId = items[i].get<int>();
+            auto it = found.find(memberId);
+
+            if (it == found.end()) {
+                results[i] = bulkItemError(i, 404, "Crew member not found with id of " + std::to_string(memberId));
+            } else if (it->second) {
+                results[i] = bulkItemError(i, 400, "Crew member is already assigned to this crew");
+            } else {
+                insert.row().bind(crewId).bind(memberId);
+                rowItems.push_back(i);
+            }
+        }
+
+        if (!insert.empty()) {
+            db->executeBulkInsert(insert);
+        }
+
+        transaction.commit();
+
+        for (size_t i : rowItems) {
+            json item;
+            item["index"] = i;
+            item["status"] = 200;
+            item["success"] = true;
+            item["data"] = {{"crew_id", crewId}, {"crew_member_id", items[i].get<int>()}};
+            results[i] = item;
+        }
+
+        size_t assigned = rowItems.size();
+        size_t failed = items.size() - assigned;
+
+        json response;
+        response["success"] = failed == 0;
+        response["assigned"] = assigned;
+        response["failed"] = failed;
+        response["data"] = results;
+
+        // 207 Multi-Status when some items failed; each item carries its own status
+        return crow::response(failed == 0 ? 200 : 207, response.dump(4));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("SQL error in assignCrewMembersBulk: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = "Database error";
+
+        return crow::response(500, error.dump(4));
+    }
+    catch (const json::exception& e) {
+        LOG_ERROR("JSON parsing error: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = "Invalid JSON format";
+
+        return crow::response(400, error.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in assignCrewMembersBulk: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
+
+crow::response CrewController::removeCrewMember(const crow::request& req) {
+    try {
+        int crewId = std::stoi(req.url_params.get("id"));
+        int memberId = std::stoi(req.url_params.get("memberId"));
+
+        // Get database connection
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
+
+        // Checks and delete run in one transaction; it rolls back on any early return or error
+        auto transaction = db->beginTransaction();
+
+        // Check if crew exists, locking it so two removals cannot both pass the composition check
+        auto checkCrewStmt = db->prepareStatement("SELECT crew_id FROM crews WHERE crew_id = ? FOR UPDATE");
+        checkCrewStmt->setInt(1, crewId);
+        auto checkCrewResult = db->executeQuery(checkCrewStmt);
+
+        if (!checkCrewResult->next()) {
+            json error;
+            error["success"] = false;
+            error["error"] = "Crew not found with id of " + std::to_string(crewId);
+            return crow::response(404, error.dump(4));
+        }
+
+        // Check if assignment exists
+        auto checkAssignmentStmt = db->prepareStatement(
+            "SELECT COUNT(*) AS count FROM crew_assignments WHERE crew_id = ? AND crew_member_id = ?"
+        );
+        checkAssignmentStmt->setInt(1, crewId);
+        checkAssignmentStmt->setInt(2, memberId);
+        auto checkAssignmentResult = db->executeQuery(checkAssignmentStmt);
+
+        checkAssignmentResult->next();
+        if (checkAssignmentResult->getInt("count") == 0) {
+            json error;
+            error["success"] = false;
+            error["error"] = "Crew member not found in this crew";
+            return crow::response(404, error.dump(4));
+        }
+
+        // Check if this crew is assigned to any aircraft
+        auto aircraftStmt = db->prepareStatement("SELECT * FROM aircraft WHERE crew_id = ?");
+        aircraftStmt->setInt(1, crewId);
+        auto aircraftResult = db->executeQuery(aircraftStmt);
+
+        if (aircraftResult->next()) {
+            // Need to check if removing this member would make the crew invalid
+            // Get the role of the member being removed
+            auto roleStmt = db->prepareStatement(
+                "SELECT role FROM crew_members WHERE crew_member_id = ?"
+            );
+            roleStmt->setInt(1, memberId);
+            auto roleResult = db->executeQuery(roleStmt);
+
+            if (roleResult->next()) {
+                std::string role = roleResult->getString("role").c_str();
+
+                // Count members with this role
+                auto countRoleStmt = db->prepareStatement(R"(
+                    SELECT COUNT(*) AS count
+                    FROM crew_assignments ca
+                    JOIN crew_members cm ON ca.crew_member_id = cm.crew_member_id
+                    WHERE ca.crew_id = ? AND cm.role = ?
+                )");
+                countRoleStmt->setInt(1, crewId);
+                countRoleStmt->setString(2, role);
+                auto countRoleResult = db->executeQuery(countRoleStmt);
+
+                countRoleResult->next();
+                int roleCount = countRoleResult->getInt("count");
+
+                // Check if removing would make the crew invalid
+                if ((role == "captain" && roleCount <= 1) ||
+                    (role == "pilot" && roleCount <= 1) ||
+                    (role == "flight_attendant" && roleCount <= 2)) {
+
+                    json error;
+                    error["success"] = false;
+                    error["error"] = "Cannot remove member. Crew would not meet minimum requirements.";
+                    return crow::response(400, error.dump(4));
+                }
+            }
+        }
+
+        // Remove assignment
+        auto removeStmt = db->prepareStatement(
+            "DELETE FROM crew_assignments WHERE crew_id = ? AND crew_member_id = ?"
+        );
+        removeStmt->setInt(1, crewId);
+        removeStmt->setInt(2, memberId);
+        db->executeUpdate(removeStmt);
+
+        transaction.commit();
+
         // Get updated crew members
         auto membersStmt = db->prepareStatement(R"(
             SELECT
@@ -622,382 +967,228 @@ crow::response CrewController::assignCrewMember(const crow::request& req) {
                 cm.license_number,
                 cm.experience_years
             FROM crew_members cm
-                        JOIN crew_assignments ca ON cm.crew_member_id = ca.crew_member_id
-                        WHERE ca.crew_id = ?
-                        ORDER BY cm.role, cm.last_name, cm.first_name
-                    )");
-                    membersStmt->setInt(1, crewId);
-
-                    auto membersResult = db->executeQuery(membersStmt);
-
-                    // Build response JSON
-                    json crewMembersArray = json::array();
-
-                    while (membersResult->next()) {
-                        json crewMember;
-                        crewMember["crew_member_id"] = membersResult->getInt("crew_member_id");
-                        crewMember["first_name"] = membersResult->getString("first_name");
-                        crewMember["last_name"] = membersResult->getString("last_name");
-                        crewMember["role"] = membersResult->getString("role");
-                        crewMember["license_number"] = membersResult->isNull("license_number") ? nullptr : membersResult->getString("license_number");
-                        crewMember["experience_years"] = membersResult->getInt("experience_years");
-
-                        crewMembersArray.push_back(crewMember);
-                    }
-
-                    json response;
-                    response["success"] = true;
-                    response["count"] = crewMembersArray.size();
-                    response["data"] = crewMembersArray;
-
-                    return crow::response(200, response.dump(4));
-                }
-                catch (const sql::SQLException& e) {
-                    LOG_ERROR("SQL error in assignCrewMember: " + std::string(e.what()));
+            JOIN crew_assignments ca ON cm.crew_member_id = ca.crew_member_id
+            WHERE ca.crew_id = ?
+            ORDER BY cm.role, cm.last_name, cm.first_name
+        )");
+        membersStmt->setInt(1, crewId);
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = "Database error";
+        auto membersResult = db->executeQuery(membersStmt);
 
-                    return crow::response(500, error.dump(4));
-                }
-                catch (const json::exception& e) {
-                    LOG_ERROR("JSON parsing error: " + std::string(e.what()));
+        // Build response JSON
+        json crewMembersArray = json::array();
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = "Invalid JSON format";
+        while (membersResult->next()) {
+            json crewMember;
+            crewMember["crew_member_id"] = membersResult->getInt("crew_member_id");
+            crewMember["first_name"] = membersResult->getString("first_name");
+            crewMember["last_name"] = membersResult->getString("last_name");
+            crewMember["role"] = membersResult->getString("role");
+            crewMember["license_number"] = membersResult->isNull("license_number") ? nullptr : membersResult->getString("license_number");
+            crewMember["experience_years"] = membersResult->getInt("experience_years");
 
-                    return crow::response(400, error.dump(4));
-                }
-                catch (const std::exception& e) {
-                    LOG_ERROR("Error in assignCrewMember: " + std::string(e.what()));
+            crewMembersArray.push_back(crewMember);
+        }
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = e.what();
+        json response;
+        response["success"] = true;
+        response["count"] = crewMembersArray.size();
+        response["data"] = crewMembersArray;
 
-                    return crow::response(500, error.dump(4));
-                }
-            }
+        return crow::response(200, response.dump(4));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("SQL error in removeCrewMember: " + std::string(e.what()));
 
-            crow::response CrewController::removeCrewMember(const crow::request& req) {
-                try {
-                    int crewId = std::stoi(req.url_params.get("id"));
-                    int memberId = std::stoi(req.url_params.get("memberId"));
-
-                    // Get database connection
-                    auto db = DBConnectionPool::getInstance().getConnection();
-
-                    // Check if crew exists
-                    auto checkCrewStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
-                    checkCrewStmt->setInt(1, crewId);
-                    auto checkCrewResult = db->executeQuery(checkCrewStmt);
-
-                    if (!checkCrewResult->next()) {
-                        json error;
-                        error["success"] = false;
-                        error["error"] = "Crew not found with id of " + std::to_string(crewId);
-                        return crow::response(404, error.dump(4));
-                    }
-
-                    // Check if assignment exists
-                    auto checkAssignmentStmt = db->prepareStatement(
-                        "SELECT COUNT(*) AS count FROM crew_assignments WHERE crew_id = ? AND crew_member_id = ?"
-                    );
-                    checkAssignmentStmt->setInt(1, crewId);
-                    checkAssignmentStmt->setInt(2, memberId);
-                    auto checkAssignmentResult = db->executeQuery(checkAssignmentStmt);
-
-                    checkAssignmentResult->next();
-                    if (checkAssignmentResult->getInt("count") == 0) {
-                        json error;
-                        error["success"] = false;
-                        error["error"] = "Crew member not found in this crew";
-                        return crow::response(404, error.dump(4));
-                    }
-
-                    // Check if this crew is assigned to any aircraft
-                    auto aircraftStmt = db->prepareStatement("SELECT * FROM aircraft WHERE crew_id = ?");
-                    aircraftStmt->setInt(1, crewId);
-                    auto aircraftResult = db->executeQuery(aircraftStmt);
-
-                    if (aircraftResult->next()) {
-                        // Need to check if removing this member would make the crew invalid
-                        // Get the role of the member being removed
-                        auto roleStmt = db->prepareStatement(
-                            "SELECT role FROM crew_members WHERE crew_member_id = ?"
-                        );
-                        roleStmt->setInt(1, memberId);
-                        auto roleResult = db->executeQuery(roleStmt);
-
-                        if (roleResult->next()) {
-                            std::string role = roleResult->getString("role").c_str();
-
-                            // Count members with this role
-                            auto countRoleStmt = db->prepareStatement(R"(
-                                SELECT COUNT(*) AS count
-                                FROM crew_assignments ca
-                                JOIN crew_members cm ON ca.crew_member_id = cm.crew_member_id
-                                WHERE ca.crew_id = ? AND cm.role = ?
-                            )");
-                            countRoleStmt->setInt(1, crewId);
-                            countRoleStmt->setString(2, role);
-                            auto countRoleResult = db->executeQuery(countRoleStmt);
-
-                            countRoleResult->next();
-                            int roleCount = countRoleResult->getInt("count");
-
-                            // Check if removing would make the crew invalid
-                            if ((role == "captain" && roleCount <= 1) ||
-                                (role == "pilot" && roleCount <= 1) ||
-                                (role == "flight_attendant" && roleCount <= 2)) {
-
-                                json error;
-                                error["success"] = false;
-                                error["error"] = "Cannot remove member. Crew would not meet minimum requirements.";
-                                return crow::response(400, error.dump(4));
-                            }
-                        }
-                    }
-
-                    // Remove assignment
-                    auto removeStmt = db->prepareStatement(
-                        "DELETE FROM crew_assignments WHERE crew_id = ? AND crew_member_id = ?"
-                    );
-                    removeStmt->setInt(1, crewId);
-                    removeStmt->setInt(2, memberId);
-                    db->executeUpdate(removeStmt);
-
-                    // Get updated crew members
-                    auto membersStmt = db->prepareStatement(R"(
-                        SELECT
-                            cm.crew_member_id,
-                            cm.first_name,
-                            cm.last_name,
-                            cm.role,
-                            cm.license_number,
-                            cm.experience_years
-                        FROM crew_members cm
-                        JOIN crew_assignments ca ON cm.crew_member_id = ca.crew_member_id
-                        WHERE ca.crew_id = ?
-                        ORDER BY cm.role, cm.last_name, cm.first_name
-                    )");
-                    membersStmt->setInt(1, crewId);
-
-                    auto membersResult = db->executeQuery(membersStmt);
-
-                    // Build response JSON
-                    json crewMembersArray = json::array();
-
-                    while (membersResult->next()) {
-                        json crewMember;
-                        crewMember["crew_member_id"] = membersResult->getInt("crew_member_id");
-                        crewMember["first_name"] = membersResult->getString("first_name");
-                        crewMember["last_name"] = membersResult->getString("last_name");
-                        crewMember["role"] = membersResult->getString("role");
-                        crewMember["license_number"] = membersResult->isNull("license_number") ? nullptr : membersResult->getString("license_number");
-                        crewMember["experience_years"] = membersResult->getInt("experience_years");
-
-                        crewMembersArray.push_back(crewMember);
-                    }
-
-                    json response;
-                    response["success"] = true;
-                    response["count"] = crewMembersArray.size();
-                    response["data"] = crewMembersArray;
-
-                    return crow::response(200, response.dump(4));
-                }
-                catch (const sql::SQLException& e) {
-                    LOG_ERROR("SQL error in removeCrewMember: " + std::string(e.what()));
+        json error;
+        error["success"] = false;
+        error["error"] = "Database error";
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = "Database error";
+        return crow::response(500, error.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in removeCrewMember: " + std::string(e.what()));
 
-                    return crow::response(500, error.dump(4));
-                }
-                catch (const std::exception& e) {
-                    LOG_ERROR("Error in removeCrewMember: " + std::string(e.what()));
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = e.what();
+        return crow::response(500, error.dump(4));
+    }
+}
 
-                    return crow::response(500, error.dump(4));
-                }
-            }
+crow::response CrewController::getCrewAircraft(const crow::request& req) {
+    try {
+        int crewId = std::stoi(req.url_params.get("id"));
 
-            crow::response CrewController::getCrewAircraft(const crow::request& req) {
-                try {
-                    int crewId = std::stoi(req.url_params.get("id"));
-
-                    // Get database connection
-                    auto db = DBConnectionPool::getInstance().getConnection();
-
-                    // Check if crew exists
-                    auto checkStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
-                    checkStmt->setInt(1, crewId);
-                    auto checkResult = db->executeQuery(checkStmt);
-
-                    if (!checkResult->next()) {
-                        json error;
-                        error["success"] = false;
-                        error["error"] = "Crew not found with id of " + std::to_string(crewId);
-                        return crow::response(404, error.dump(4));
-                    }
-
-                    // Get aircraft assigned to this crew
-                    std::string query = R"(
-                        SELECT
-                            a.aircraft_id,
-                            a.model,
-                            a.registration_number,
-                            a.capacity,
-                            a.status
-                        FROM aircraft a
-                        WHERE a.crew_id = ?
-                    )";
-
-                    auto stmt = db->prepareStatement(query);
-                    stmt->setInt(1, crewId);
-
-                    auto result = db->executeQuery(stmt);
-
-                    // Build response JSON
-                    json aircraftArray = json::array();
-
-                    while (result->next()) {
-                        json aircraft;
-                        aircraft["aircraft_id"] = result->getInt("aircraft_id");
-                        aircraft["model"] = result->getString("model");
-                        aircraft["registration_number"] = result->getString("registration_number");
-                        aircraft["capacity"] = result->getInt("capacity");
-                        aircraft["status"] = result->getString("status");
-
-                        aircraftArray.push_back(aircraft);
-                    }
-
-                    json response;
-                    response["success"] = true;
-                    response["count"] = aircraftArray.size();
-                    response["data"] = aircraftArray;
-
-                    return crow::response(200, response.dump(4));
-                }
-                catch (const sql::SQLException& e) {
-                    LOG_ERROR("SQL error in getCrewAircraft: " + std::string(e.what()));
+        // Get database connection
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = "Database error";
+        // Get aircraft assigned to this crew
+        std::string query = R"(
+            SELECT
+                a.aircraft_id,
+                a.model,
+                a.registration_number,
+                a.capacity,
+                a.status
+            FROM aircraft a
+            WHERE a.crew_id = ?
+        )";
 
-                    return crow::response(500, error.dump(4));
-                }
-                catch (const std::exception& e) {
-                    LOG_ERROR("Error in getCrewAircraft: " + std::string(e.what()));
+        // Check the crew exists and run the main query in one round trip
+        auto batch = db->executeBatch(QueryBatch()
+            .add("SELECT crew_id FROM crews WHERE crew_id = ?").bind(crewId)
+            .add(query).bind(crewId));
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = e.what();
+        if (!batch.next()->next()) {
+            json error;
+            error["success"] = false;
+            error["error"] = "Crew not found with id of " + std::to_string(crewId);
+            return crow::response(404, error.dump(4));
+        }
 
-                    return crow::response(500, error.dump(4));
-                }
-            }
+        auto result = batch.next();
 
-            crow::response CrewController::validateCrew(const crow::request& req) {
-                try {
-                    int crewId = std::stoi(req.url_params.get("id"));
-
-                    // Get database connection
-                    auto db = DBConnectionPool::getInstance().getConnection();
-
-                    // Check if crew exists
-                    auto checkStmt = db->prepareStatement("SELECT * FROM crews WHERE crew_id = ?");
-                    checkStmt->setInt(1, crewId);
-                    auto checkResult = db->executeQuery(checkStmt);
-
-                    if (!checkResult->next()) {
-                        json error;
-                        error["success"] = false;
-                        error["error"] = "Crew not found with id of " + std::to_string(crewId);
-                        return crow::response(404, error.dump(4));
-                    }
-
-                    // Count by role
-                    std::string query = R"(
-                        SELECT
-                            SUM(CASE WHEN cm.role = 'captain' THEN 1 ELSE 0 END) AS captain_count,
-                            SUM(CASE WHEN cm.role = 'pilot' THEN 1 ELSE 0 END) AS pilot_count,
-                            SUM(CASE WHEN cm.role = 'flight_attendant' THEN 1 ELSE 0 END) AS attendant_count
-                        FROM crew_assignments ca
-                        JOIN crew_members cm ON ca.crew_member_id = cm.crew_member_id
-                        WHERE ca.crew_id = ?
-                    )";
-
-                    auto stmt = db->prepareStatement(query);
-                    stmt->setInt(1, crewId);
-
-                    auto result = db->executeQuery(stmt);
-                    result->next();
-
-                    int captainCount = result->getInt("captain_count");
-                    int pilotCount = result->getInt("pilot_count");
-                    int attendantCount = result->getInt("attendant_count");
-
-                    // Validation rules
-                    bool isValid = true;
-                    json messages = json::array();
-
-                    if (captainCount < 1) {
-                        isValid = false;
-                        messages.push_back("Crew must have at least one captain");
-                    }
-
-                    if (pilotCount < 1) {
-                        isValid = false;
-                        messages.push_back("Crew must have at least one pilot");
-                    }
-
-                    if (attendantCount < 2) {
-                        isValid = false;
-                        messages.push_back("Crew must have at least two flight attendants");
-                    }
-
-                    // Build response JSON
-                    json validationResult;
-                    validationResult["valid"] = isValid;
-                    validationResult["messages"] = messages;
-                    validationResult["composition"] = {
-                        {"captains", captainCount},
-                        {"pilots", pilotCount},
-                        {"flight_attendants", attendantCount},
-                        {"total", captainCount + pilotCount + attendantCount}
-                    };
-
-                    json response;
-                    response["success"] = true;
-                    response["data"] = validationResult;
-
-                    return crow::response(200, response.dump(4));
-                }
-                catch (const sql::SQLException& e) {
-                    LOG_ERROR("SQL error in validateCrew: " + std::string(e.what()));
+        // Build response JSON
+        json aircraftArray = json::array();
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = "Database error";
+        while (result->next()) {
+            json aircraft;
+            aircraft["aircraft_id"] = result->getInt("aircraft_id");
+            aircraft["model"] = result->getString("model");
+            aircraft["registration_number"] = result->getString("registration_number");
+            aircraft["capacity"] = result->getInt("capacity");
+            aircraft["status"] = result->getString("status");
+
+            aircraftArray.push_back(aircraft);
+        }
 
-                    return crow::response(500, error.dump(4));
-                }
-                catch (const std::exception& e) {
-                    LOG_ERROR("Error in validateCrew: " + std::string(e.what()));
+        json response;
+        response["success"] = true;
+        response["count"] = aircraftArray.size();
+        response["data"] = aircraftArray;
 
-                    json error;
-                    error["success"] = false;
-                    error["error"] = e.what();
+        return crow::response(200, response.dump(4));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("SQL error in getCrewAircraft: " + std::string(e.what()));
 
-                    return crow::response(500, error.dump(4));
-                }
-            }
+        json error;
+        error["success"] = false;
+        error["error"] = "Database error";
+
+        return crow::response(500, error.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in getCrewAircraft: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
+
+crow::response CrewController::validateCrew(const crow::request& req) {
+    try {
+        int crewId = std::stoi(req.url_params.get("id"));
+
+        // Get database connection
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
+
+        // Count by role
+        std::string query = R"(
+            SELECT
+                SUM(CASE WHEN cm.role = 'captain' THEN 1 ELSE 0 END) AS captain_count,
+                SUM(CASE WHEN cm.role = 'pilot' THEN 1 ELSE 0 END) AS pilot_count,
+                SUM(CASE WHEN cm.role = 'flight_attendant' THEN 1 ELSE 0 END) AS attendant_count
+            FROM crew_assignments ca
+            JOIN crew_members cm ON ca.crew_member_id = cm.crew_member_id
+            WHERE ca.crew_id = ?
+        )";
+
+        // Check the crew exists and run the main query in one round trip
+        auto batch = db->executeBatch(QueryBatch()
+            .add("SELECT crew_id FROM crews WHERE crew_id = ?").bind(crewId)
+            .add(query).bind(crewId));
+
+        if (!batch.next()->next()) {
+            json error;
+            error["success"] = false;
+            error["error"] = "Crew not found with id of " + std::to_string(crewId);
+            return crow::response(404, error.dump(4));
+        }
+
+        auto result = batch.next();
+        result->next();
+
+        int captainCount = result->getInt("captain_count");
+        int pilotCount = result->getInt("pilot_count");
+        int attendantCount = result->getInt("attendant_count");
+
+        // Validation rules
+        bool isValid = true;
+        json messages = json::array();
+
+        if (captainCount < 1) {
+            isValid = false;
+            messages.push_back("Crew must have at least one captain");
+        }
+
+        if (pilotCount < 1) {
+            isValid = false;
+            messages.push_back("Crew must have at least one pilot");
+        }
+
+        if (attendantCount < 2) {
+            isValid = false;
+            messages.push_back("Crew must have at least two flight attendants");
+        }
+
+        // Build response JSON
+        json validationResult;
+        validationResult["valid"] = isValid;
+        validationResult["messages"] = messages;
+        validationResult["composition"] = {
+            {"captains", captainCount},
+            {"pilots", pilotCount},
+            {"flight_attendants", attendantCount},
+            {"total", captainCount + pilotCount + attendantCount}
+        };
+
+        json response;
+        response["success"] = true;
+        response["data"] = validationResult;
+
+        return crow::response(200, response.dump(4));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("SQL error in validateCrew: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = "Database error";
+
+        return crow::response(500, error.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in validateCrew: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
@@ -1,6 +1,82 @@
 #include "../../include/controllers/CrewMemberController.h"
 #include <stdexcept>
 #include <sstream>
+#include <unordered_map>
+
+namespace {
+    // Bulk requests are capped so one request cannot hold a write transaction for long
+    const size_t kMaxBulkItems = 1000;
+
+    struct CrewMemberInput {
+        std::string firstName;
+        std::string lastName;
+        std::string role;
+        std::string licenseNumber;
+        std::string dateOfBirth;
+        int experienceYears = 0;
+        std::string contactNumber;
+        std::string email;
+    };
+
+    // Read and validate the fields of a new crew member; returns the error message, empty when valid
+    std::string parseCrewMember(const json& requestData, CrewMemberInput& input) {
+        // Validate required fields
+        if (!requestData.is_object() ||
+            !requestData.contains("first_name") || !requestData.contains("last_name") ||
+            !requestData.contains("role") || !requestData.contains("date_of_birth") ||
+            !requestData.contains("experience_years") || !requestData.contains("contact_number") ||
+            !requestData.contains("email")) {
+            return "Missing required fields";
+        }
+
+        input.firstName = requestData["first_name"];
+        input.lastName = requestData["last_name"];
+        input.role = requestData["role"];
+        input.licenseNumber = requestData.contains("license_number") ?
+                              requestData["license_number"].get<std::string>() : "";
+        input.dateOfBirth = requestData["date_of_birth"];
+        input.experienceYears = requestData["experience_years"];
+        input.contactNumber = requestData["contact_number"];
+        input.email = requestData["email"];
+
+        // Validate role
+        if (input.role != "captain" && input.role != "pilot" && input.role != "flight_attendant") {
+            return "Role must be captain, pilot, or flight_attendant";
+        }
+
+        // Validate license number for captains and pilots
+        if ((input.role == "captain" || input.role == "pilot") && input.licenseNumber.empty()) {
+            return "License number is required for captains and pilots";
+        }
+
+        return "";
+    }
+
+    // Response JSON built from the inserted values; no read-back is needed
+    json crewMemberJson(const CrewMemberInput& input, int crewMemberId) {
+        json crewMember;
+        crewMember["crew_member_id"] = crewMemberId;
+        crewMember["first_name"] = input.firstName;
+        crewMember["last_name"] = input.lastName;
+        crewMember["role"] = input.role;
+        crewMember["license_number"] = input.licenseNumber.empty() ? json(nullptr) : json(input.licenseNumber);
+        crewMember["date_of_birth"] = input.dateOfBirth;
+        crewMember["experience_years"] = input.experienceYears;
+        crewMember["contact_number"] = input.contactNumber;
+        crewMember["email"] = input.email;
+        crewMember["crew_count"] = 0; // New crew member is not assigned to any crew yet
+        return crewMember;
+    }
+
+    json bulkItemError(size_t index, int status, const std::string& message) {
+        json item;
+        item["index"] = index;
+        item["status"] = status;
+        item["success"] = false;
+        item["error"] = message;
+        return item;
+    }
+}
 
 crow::response CrewMemberController::getCrewMembers(const crow::request& req) {
     try {
@@ -24,96 +100,107 @@ crow::response CrewMemberController::getCrewMembers(const crow::request& req) {
         // Calculate offset
         int offset = (page - 1) * limit;
 
-        // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
-
-        // Build query with role filter if needed
-        std::stringstream queryStream;
-        queryStream << R"(
-            SELECT
-                cm.crew_member_id,
-                cm.first_name,
-                cm.last_name,
-                cm.role,
-                cm.license_number,
-                cm.date_of_birth,
-                cm.experience_years,
-                cm.contact_number,
-                cm.email,
-                (SELECT COUNT(*) FROM crew_assignments ca WHERE ca.crew_member_id = cm.crew_member_id) AS crew_count
-            FROM crew_members cm
-        )";
-
-        if (!role.empty()) {
-            queryStream << " WHERE cm.role = ?";
-        }
-
-        queryStream << R"(
-            ORDER BY cm.last_name, cm.first_name
-            LIMIT ? OFFSET ?
-        )";
-
-        std::string query = queryStream.str();
-        auto stmt = db->prepareStatement(query);
-
-        int paramIndex = 1;
-        if (!role.empty()) {
-            stmt->setString(paramIndex++, role);
-        }
-        stmt->setInt(paramIndex++, limit);
-        stmt->setInt(paramIndex, offset);
+        // Run the queries on the database executor so slow ones do not hold HTTP workers
+        int userId = get_user_id(req);
+        auto future = DBExecutor::getInstance().submit([=]() {
+            // Get database connection
+            auto db = DBConnectionPool::getInstance().getReadConnection(userId);
+
+            // Build query with role filter if needed
+            std::stringstream queryStream;
+            queryStream << R"(
+                SELECT
+                    cm.crew_member_id,
+                    cm.first_name,
+                    cm.last_name,
+                    cm.role,
+                    cm.license_number,
+                    cm.date_of_birth,
+                    cm.experience_years,
+                    cm.contact_number,
+                    cm.email,
+                    (SELECT COUNT(*) FROM crew_assignments ca WHERE ca.crew_member_id = cm.crew_member_id) AS crew_count
+                FROM crew_members cm
+            )";
+
+            if (!role.empty()) {
+                queryStream << " WHERE cm.role = ?";
+            }
 
-        auto result = db->executeQuery(stmt);
+            queryStream << R"(
+                ORDER BY cm.last_name, cm.first_name
+                LIMIT ? OFFSET ?
+            )";
 
-        // Build count query with the same filter
-        std::stringstream countQueryStream;
-        countQueryStream << "SELECT COUNT(*) as count FROM crew_members";
+            // Build count query with the same filter
+            std::stringstream countQueryStream;
+            countQueryStream << "SELECT COUNT(*) as count FROM crew_members";
 
-        if (!role.empty()) {
-            countQueryStream << " WHERE role = ?";
-        }
+            if (!role.empty()) {
+                countQueryStream << " WHERE role = ?";
+            }
 
-        auto countStmt = db->prepareStatement(countQueryStream.str());
-        if (!role.empty()) {
-            countStmt->setString(1, role);
-        }
+            // Fetch the total count and the page in one round trip
+            QueryBatch batch;
+            batch.add(countQueryStream.str());
+            if (!role.empty()) {
+                batch.bind(role);
+            }
 
-        auto countResult = db->executeQuery(countStmt);
-        countResult->next();
-        int totalCount = countResult->getInt("count");
+            batch.add(queryStream.str());
+            if (!role.empty()) {
+                batch.bind(role);
+            }
+            batch.bind(limit).bind(offset);
+
+            auto results = db->executeBatch(batch);
+
+            auto countResult = results.next();
+            countResult->next();
+            int totalCount = countResult->getInt("count");
+
+            auto result = results.next();
+
+            // Build response JSON
+            json response;
+            json crewMembersArray = json::array();
+
+            while (result->next()) {
+                json crewMember;
+                crewMember["crew_member_id"] = result->getInt("crew_member_id");
+                crewMember["first_name"] = result->getString("first_name");
+                crewMember["last_name"] = result->getString("last_name");
+                crewMember["role"] = result->getString("role");
+                crewMember["license_number"] = result->isNull("license_number") ? nullptr : result->getString("license_number");
+                crewMember["date_of_birth"] = result->getString("date_of_birth");
+                crewMember["experience_years"] = result->getInt("experience_years");
+                crewMember["contact_number"] = result->getString("contact_number");
+                crewMember["email"] = result->getString("email");
+                crewMember["crew_count"] = result->getInt("crew_count");
+
+                crewMembersArray.push_back(crewMember);
+            }
 
-        // Build response JSON
-        json response;
-        json crewMembersArray = json::array();
+            response["success"] = true;
+            response["count"] = crewMembersArray.size();
+            response["pagination"] = {
+                {"page", page},
+                {"limit", limit},
+                {"totalPages", (int)std::ceil((double)totalCount / limit)},
+                {"totalItems", totalCount}
+            };
+            response["data"] = crewMembersArray;
 
-        while (result->next()) {
-            json crewMember;
-            crewMember["crew_member_id"] = result->getInt("crew_member_id");
-            crewMember["first_name"] = result->getString("first_name");
-            crewMember["last_name"] = result->getString("last_name");
-            crewMember["role"] = result->getString("role");
-            crewMember["license_number"] = result->isNull("license_number") ? nullptr : result->getString("license_number");
-            crewMember["date_of_birth"] = result->getString("date_of_birth");
-            crewMember["experience_years"] = result->getInt("experience_years");
-            crewMember["contact_number"] = result->getString("contact_number");
-            crewMember["email"] = result->getString("email");
-            crewMember["crew_count"] = result->getInt("crew_count");
-
-            crewMembersArray.push_back(crewMember);
-        }
+            return response;
+        });
 
-        response["success"] = true;
-        response["count"] = crewMembersArray.size();
-        response["pagination"] = {
-            {"page", page},
-            {"limit", limit},
-            {"totalPages", (int)std::ceil((double)totalCount / limit)},
-            {"totalItems", totalCount}
-        };
-        response["data"] = crewMembersArray;
+        json response = future.get();
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getCrewMembers: " + std::string(e.what()));
 
@@ -139,7 +226,7 @@ crow::response CrewMemberController::getCrewMember(const crow::request& req) {
         int crewMemberId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
 
         // Get crew member details
         std::string query = R"(
@@ -189,6 +276,9 @@ crow::response CrewMemberController::getCrewMember(const crow::request& req) {
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getCrewMember: " + std::string(e.what()));
 
@@ -214,46 +304,19 @@ crow::response CrewMemberController::createCrewMember(const crow::request& req)
         // Parse request body
         json requestData = json::parse(req.body);
 
-        // Validate required fields
-        if (!requestData.contains("first_name") || !requestData.contains("last_name") ||
-            !requestData.contains("role") || !requestData.contains("date_of_birth") ||
-            !requestData.contains("experience_years") || !requestData.contains("contact_number") ||
-            !requestData.contains("email")) {
-
-            json error;
-            error["success"] = false;
-            error["error"] = "Missing required fields";
-            return crow::response(400, error.dump(4));
-        }
-
-        std::string firstName = requestData["first_name"];
-        std::string lastName = requestData["last_name"];
-        std::string role = requestData["role"];
-        std::string licenseNumber = requestData.contains("license_number") ?
-                                    requestData["license_number"].get<std::string>() : "";
-        std::string dateOfBirth = requestData["date_of_birth"];
-        int experienceYears = requestData["experience_years"];
-        std::string contactNumber = requestData["contact_number"];
-        std::string email = requestData["email"];
-
-        // Validate role
-        if (role != "captain" && role != "pilot" && role != "flight_attendant") {
+        CrewMemberInput input;
+        std::string validationError = parseCrewMember(requestData, input);
+        if (!validationError.empty()) {
             json error;
             error["success"] = false;
-            error["error"] = "Role must be captain, pilot, or flight_attendant";
+            error["error"] = validationError;
             return crow::response(400, error.dump(4));
         }
 
-        // Validate license number for captains and pilots
-        if ((role == "captain" || role == "pilot") && licenseNumber.empty()) {
-            json error;
-            error["success"] = false;
-            error["error"] = "License number is required for captains and pilots";
-            return crow::response(400, error.dump(4));
-        }
+        const std::string& licenseNumber = input.licenseNumber;
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
         // Check if license number already exists (for captain and pilot roles)
         if (!licenseNumber.empty()) {
@@ -277,67 +340,31 @@ crow::response CrewMemberController::createCrewMember(const crow::request& req)
             VALUES (?, ?, ?, ?, ?, ?, ?, ?)
         )";
 
-        auto stmt = db->prepareStatement(query);
-        stmt->setString(1, firstName);
-        stmt->setString(2, lastName);
-        stmt->setString(3, role);
+        auto stmt = db->prepareInsert(query);
+        stmt->setString(1, input.firstName);
+        stmt->setString(2, input.lastName);
+        stmt->setString(3, input.role);
         if (!licenseNumber.empty()) {
             stmt->setString(4, licenseNumber);
         } else {
             stmt->setNull(4, sql::DataType::VARCHAR);
         }
-        stmt->setString(5, dateOfBirth);
-        stmt->setInt(6, experienceYears);
-        stmt->setString(7, contactNumber);
-        stmt->setString(8, email);
-
-        db->executeUpdate(stmt);
+        stmt->setString(5, input.dateOfBirth);
+        stmt->setInt(6, input.experienceYears);
+        stmt->setString(7, input.contactNumber);
+        stmt->setString(8, input.email);
 
-        // Get the last insert ID
-        auto idStmt = db->prepareStatement("SELECT LAST_INSERT_ID()");
-        auto idResult = db->executeQuery(idStmt);
-        idResult->next();
-        int crewMemberId = idResult->getInt(1);
-
-        // Get the created crew member
-        auto getStmt = db->prepareStatement(R"(
-            SELECT
-                crew_member_id,
-                first_name,
-                last_name,
-                role,
-                license_number,
-                date_of_birth,
-                experience_years,
-                contact_number,
-                email
-            FROM crew_members
-            WHERE crew_member_id = ?
-        )");
-        getStmt->setInt(1, crewMemberId);
-        auto getResult = db->executeQuery(getStmt);
-
-        getResult->next();
-
-        // Build response JSON
-        json crewMember;
-        crewMember["crew_member_id"] = getResult->getInt("crew_member_id");
-        crewMember["first_name"] = getResult->getString("first_name");
-        crewMember["last_name"] = getResult->getString("last_name");
-        crewMember["role"] = getResult->getString("role");
-        crewMember["license_number"] = getResult->isNull("license_number") ? nullptr : getResult->getString("license_number");
-        crewMember["date_of_birth"] = getResult->getString("date_of_birth");
-        crewMember["experience_years"] = getResult->getInt("experience_years");
-        crewMember["contact_number"] = getResult->getString("contact_number");
-        crewMember["email"] = getResult->getString("email");
-        crewMember["crew_count"] = 0; // New crew member is not assigned to any crew yet
+        int crewMemberId = static_cast<int>(db->executeInsert(stmt));
 
         json response;
         response["success"] = true;
-        response["data"] = crewMember;
+        response["data"] = crewMemberJson(input, crewMemberId);
 
         return crow::response(201, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in createCrewMember: " + std::string(e.what()));
 
@@ -367,6 +394,177 @@ crow::response CrewMemberController::createCrewMember(const crow::request& req)
     }
 }
 
+crow::response CrewMemberController::createCrewMembersBulk(const crow::request& req) {
+    try {
+        // Parse request body: a bare array or {"crew_members": [...]}
+        json requestData = json::parse(req.body);
+        json items = requestData.is_object() && requestData.contains("crew_members") ?
+                     requestData["crew_members"] : requestData;
+
+        if (!items.is_array() || items.empty()) {
+            json error;
+            error["success"] = false;
+            error["error"] = "Please provide an array of crew members";
+            return crow::response(400, error.dump(4));
+        }
+
+        if (items.size() > kMaxBulkItems) {
+            json error;
+            error["success"] = false;
+            error["error"] = "At most " + std::to_string(kMaxBulkItems) + " crew members per request";
+            return crow::response(400, error.dump(4));
+        }
+
+        // Validate every item up front; failed items get their result now and are skipped
+        std::vector<CrewMemberInput> inputs(items.size());
+        std::vector<json> results(items.size());
+        std::vector<bool> accepted(items.size(), false);
+        std::unordered_map<std::string, size_t> licenseItems; // license number -> item index
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            std::string validationError;
+            try {
+                validationError = parseCrewMember(items[i], inputs[i]);
+            }
+            catch (const json::exception&) {
+                validationError = "Invalid field types";
+            }
+
+            if (!validationError.empty()) {
+                results[i] = bulkItemError(i, 400, validationError);
+                continue;
+            }
+
+            const std::string& licenseNumber = inputs[i].licenseNumber;
+            if (!licenseNumber.empty() && !licenseItems.emplace(licenseNumber, i).second) {
+                results[i] = bulkItemError(i, 409, "Duplicate license number in request");
+                continue;
+            }
+
+            accepted[i] = true;
+        }
+
+        // Get database connection
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
+
+        // Duplicate check and inserts run in one transaction; it rolls back on any error
+        auto transaction = db->beginTransaction();
+
+        // Check all license numbers against existing crew members in one query
+        if (!licenseItems.empty()) {
+            std::string placeholders;
+            for (size_t i = 0; i < licenseItems.size(); ++i) {
+                placeholders += i > 0 ? ", ?" : "?";
+            }
+
+            QueryBatch batch;
+            batch.add("SELECT license_number FROM crew_members WHERE license_number IN (" + placeholders + ")");
+            for (const auto& [licenseNumber, index] : licenseItems) {
+                batch.bind(licenseNumber);
+            }
+
+            auto checkResults = db->executeBatch(batch);
+            auto existing = checkResults.next();
+            while (existing->next()) {
+                auto it = licenseItems.find(existing->getString("license_number").c_str());
+                if (it != licenseItems.end()) {
+                    accepted[it->second] = false;
+                    results[it->second] = bulkItemError(it->second, 409, "Crew member with this license number already exists");
+                }
+            }
+        }
+
+        // Insert the accepted items as multi-row INSERTs
+        BulkInsert insert("crew_members", {
+            "first_name", "last_name", "role", "license_number",
+            "date_of_birth", "experience_years", "contact_number", "email"
+        });
+        std::vector<size_t> rowItems;
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (!accepted[i]) {
+                continue;
+            }
+
+            const auto& input = inputs[i];
+            insert.row()
+                .bind(input.firstName)
+                .bind(input.lastName)
+                .bind(input.role);
+            if (!input.licenseNumber.empty()) {
+                insert.bind(input.licenseNumber);
+            } else {
+                insert.bindNull();
+            }
+            insert.bind(input.dateOfBirth)
+                .bind(input.experienceYears)
+                .bind(input.contactNumber)
+                .bind(input.email);
+
+            rowItems.push_back(i);
+        }
+
+        if (!insert.empty()) {
+            auto keys = db->executeBulkInsert(insert);
+
+            for (size_t row = 0; row < rowItems.size(); ++row) {
+                size_t i = rowItems[row];
+
+                json item;
+                item["index"] = i;
+                item["status"] = 201;
+                item["success"] = true;
+                item["data"] = crewMemberJson(inputs[i], static_cast<int>(keys[row]));
+                results[i] = item;
+            }
+        }
+
+        transaction.commit();
+
+        size_t created = rowItems.size();
+        size_t failed = items.size() - created;
+
+        json response;
+        response["success"] = failed == 0;
+        response["created"] = created;
+        response["failed"] = failed;
+        response["data"] = results;
+
+        // 207 Multi-Status when some items failed; each item carries its own status
+        return crow::response(failed == 0 ? 201 : 207, response.dump(4));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("SQL error in createCrewMembersBulk: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = "Database error";
+
+        return crow::response(500, error.dump(4));
+    }
+    catch (const json::exception& e) {
+        LOG_ERROR("JSON parsing error: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = "Invalid JSON format";
+
+        return crow::response(400, error.dump(4));
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error in createCrewMembersBulk: " + std::string(e.what()));
+
+        json error;
+        error["success"] = false;
+        error["error"] = e.what();
+
+        return crow::response(500, error.dump(4));
+    }
+}
+
 crow::response CrewMemberController::updateCrewMember(const crow::request& req) {
     try {
         int crewMemberId = std::stoi(req.url_params.get("id"));
@@ -375,7 +573,7 @@ crow::response CrewMemberController::updateCrewMember(const crow::request& req)
         json requestData = json::parse(req.body);
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
         // Check if crew member exists
         auto checkStmt = db->prepareStatement("SELECT * FROM crew_members WHERE crew_member_id = ?");
@@ -533,6 +731,9 @@ crow::response CrewMemberController::updateCrewMember(const crow::request& req)
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in updateCrewMember: " + std::string(e.what()));
 
@@ -567,7 +768,7 @@ crow::response CrewMemberController::deleteCrewMember(const crow::request& req)
         int crewMemberId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getWriteConnection(get_user_id(req));
 
         // Check if crew member exists
         auto checkStmt = db->prepareStatement("SELECT * FROM crew_members WHERE crew_member_id = ?");
@@ -607,6 +808,9 @@ crow::response CrewMemberController::deleteCrewMember(const crow::request& req)
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in deleteCrewMember: " + std::string(e.what()));
 
@@ -632,7 +836,7 @@ crow::response CrewMemberController::getCrewMemberAssignments(const crow::reques
         int crewMemberId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
 
         // Check if crew member exists
         auto checkStmt = db->prepareStatement("SELECT * FROM crew_members WHERE crew_member_id = ?");
@@ -683,6 +887,9 @@ crow::response CrewMemberController::getCrewMemberAssignments(const crow::reques
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getCrewMemberAssignments: " + std::string(e.what()));
 
@@ -708,7 +915,7 @@ crow::response CrewMemberController::getCrewMemberFlights(const crow::request& r
         int crewMemberId = std::stoi(req.url_params.get("id"));
 
         // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
+        auto db = DBConnectionPool::getInstance().getReadConnection(get_user_id(req));
 
         // Check if crew member exists
         auto checkStmt = db->prepareStatement("SELECT * FROM crew_members WHERE crew_member_id = ?");
@@ -741,37 +948,49 @@ crow::response CrewMemberController::getCrewMemberFlights(const crow::request& r
             JOIN crew_assignments ca ON c.crew_id = ca.crew_id
             WHERE ca.crew_member_id = ?
             ORDER BY f.departure_time
+            LIMIT ?
         )";
 
         auto stmt = db->prepareStatement(query);
         stmt->setInt(1, crewMemberId);
+        // One row past the cap tells whether the list was cut short
+        stmt->setInt(2, static_cast<int>(JsonStreamWriter::kMaxRows + 1));
 
-        auto result = db->executeQuery(stmt);
+        // Stream rows from the server instead of buffering the whole result in the driver
+        stmt->setFetchSize(256);
 
-        // Build response JSON
-        json flightsArray = json::array();
-
-        while (result->next()) {
-            json flight;
-            flight["flight_id"] = result->getInt("flight_id");
-            flight["flight_number"] = result->getString("flight_number");
-            flight["origin"] = result->getString("origin");
-            flight["destination"] = result->getString("destination");
-            flight["departure_time"] = result->getString("departure_time");
-            flight["arrival_time"] = result->getString("arrival_time");
-            flight["status"] = result->getString("status");
-            flight["aircraft_model"] = result->getString("aircraft_model");
-            flight["registration_number"] = result->getString("registration_number");
-
-            flightsArray.push_back(flight);
-        }
-
-        json response;
-        response["success"] = true;
-        response["count"] = flightsArray.size();
-        response["data"] = flightsArray;
+        auto result = db->executeQuery(stmt);
 
-        return crow::response(200, response.dump(4));
+        // Serialize rows straight into the response body; no json document is built
+        std::string body;
+        JsonStreamWriter writer(body);
+        writer.beginObject();
+        writer.key("success");
+        writer.value(true);
+        writer.key("data");
+        writer.beginArray();
+        size_t count = writer.writeRows(*result, {
+            {"flight_id", JsonStreamWriter::ColumnType::Int},
+            {"flight_number", JsonStreamWriter::ColumnType::String},
+            {"origin", JsonStreamWriter::ColumnType::String},
+            {"destination", JsonStreamWriter::ColumnType::String},
+            {"departure_time", JsonStreamWriter::ColumnType::String},
+            {"arrival_time", JsonStreamWriter::ColumnType::String},
+            {"status", JsonStreamWriter::ColumnType::String},
+            {"aircraft_model", JsonStreamWriter::ColumnType::String},
+            {"registration_number", JsonStreamWriter::ColumnType::String}
+        });
+        writer.endArray();
+        writer.key("count");
+        writer.value(static_cast<int64_t>(count));
+        writer.key("truncated");
+        writer.value(count == JsonStreamWriter::kMaxRows && result->next());
+        writer.endObject();
+
+        return crow::response(200, std::move(body));
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
     }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getCrewMemberFlights: " + std::string(e.what()));
@@ -804,57 +1023,68 @@ crow::response CrewMemberController::searchCrewMembersByLastName(const crow::req
             return crow::response(400, error.dump(4));
         }
 
-        // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
-
-        // Search crew members by last name
-        std::string query = R"(
-            SELECT
-                cm.crew_member_id,
-                cm.first_name,
-                cm.last_name,
-                cm.role,
-                cm.license_number,
-                cm.date_of_birth,
-                cm.experience_years,
-                cm.contact_number,
-                cm.email,
-                (SELECT COUNT(*) FROM crew_assignments ca WHERE ca.crew_member_id = cm.crew_member_id) AS crew_count
-            FROM crew_members cm
-            WHERE cm.last_name = ?
-        )";
-
-        auto stmt = db->prepareStatement(query);
-        stmt->setString(1, lastName);
-
-        auto result = db->executeQuery(stmt);
+        // Run the queries on the database executor so slow ones do not hold HTTP workers
+        int userId = get_user_id(req);
+        auto future = DBExecutor::getInstance().submit([=]() {
+            // Get database connection
+            auto db = DBConnectionPool::getInstance().getReadConnection(userId);
+
+            // Search crew members by last name
+            std::string query = R"(
+                SELECT
+                    cm.crew_member_id,
+                    cm.first_name,
+                    cm.last_name,
+                    cm.role,
+                    cm.license_number,
+                    cm.date_of_birth,
+                    cm.experience_years,
+                    cm.contact_number,
+                    cm.email,
+                    (SELECT COUNT(*) FROM crew_assignments ca WHERE ca.crew_member_id = cm.crew_member_id) AS crew_count
+                FROM crew_members cm
+                WHERE cm.last_name = ?
+            )";
+
+            auto stmt = db->prepareStatement(query);
+            stmt->setString(1, lastName);
+
+            auto result = db->executeQuery(stmt);
+
+            // Build response JSON
+            json crewMembersArray = json::array();
+
+            while (result->next()) {
+                json crewMember;
+                crewMember["crew_member_id"] = result->getInt("crew_member_id");
+                crewMember["first_name"] = result->getString("first_name");
+                crewMember["last_name"] = result->getString("last_name");
+                crewMember["role"] = result->getString("role");
+                crewMember["license_number"] = result->isNull("license_number") ? nullptr : result->getString("license_number");
+                crewMember["date_of_birth"] = result->getString("date_of_birth");
+                crewMember["experience_years"] = result->getInt("experience_years");
+                crewMember["contact_number"] = result->getString("contact_number");
+                crewMember["email"] = result->getString("email");
+                crewMember["crew_count"] = result->getInt("crew_count");
+
+                crewMembersArray.push_back(crewMember);
+            }
 
-        // Build response JSON
-        json crewMembersArray = json::array();
+            json response;
+            response["success"] = true;
+            response["count"] = crewMembersArray.size();
+            response["data"] = crewMembersArray;
 
-        while (result->next()) {
-            json crewMember;
-            crewMember["crew_member_id"] = result->getInt("crew_member_id");
-            crewMember["first_name"] = result->getString("first_name");
-            crewMember["last_name"] = result->getString("last_name");
-            crewMember["role"] = result->getString("role");
-            crewMember["license_number"] = result->isNull("license_number") ? nullptr : result->getString("license_number");
-            crewMember["date_of_birth"] = result->getString("date_of_birth");
-            crewMember["experience_years"] = result->getInt("experience_years");
-            crewMember["contact_number"] = result->getString("contact_number");
-            crewMember["email"] = result->getString("email");
-            crewMember["crew_count"] = result->getInt("crew_count");
-
-            crewMembersArray.push_back(crewMember);
-        }
+            return response;
+        });
 
-        json response;
-        response["success"] = true;
-        response["count"] = crewMembersArray.size();
-        response["data"] = crewMembersArray;
+        json response = future.get();
 
         return crow::response(200, response.dump(4));
     }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
+    }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in searchCrewMembersByLastName: " + std::string(e.what()));
 
@@ -19,9 +19,6 @@ crow::response FlightController::getFlights(const crow::request& req) {
         // Calculate offset
         int offset = (page - 1) * limit;
 
-        // Get database connection
-        auto db = DBConnectionPool::getInstance().getConnection();
-
         // Prepare query
         std::string query = R"(
             SELECT
@@ -45,62 +42,91 @@ crow::response FlightController::getFlights(const crow::request& req) {
             LIMIT ? OFFSET ?
         )";
 
-        auto stmt = db->prepareStatement(query);
-        stmt->setInt(1, limit);
-        stmt->setInt(2, offset);
-
-        auto result = db->executeQuery(stmt);
-
-        // Get total count
-        auto countStmt = db->prepareStatement("SELECT COUNT(*) as count FROM flights");
-        auto countResult = db->executeQuery(countStmt);
-        countResult->next();
-        int totalCount = countResult->getInt("count");
-
-        // Build response JSON
-        json response;
-        json flightsArray = json::array();
-
-        while (result->next()) {
-            json flight;
-            flight["flight_id"] = result->getInt("flight_id");
-            flight["flight_number"] = result->getString("flight_number");
-            flight["origin"] = result->getString("origin");
-            flight["destination"] = result->getString("destination");
-            flight["departure_time"] = result->getString("departure_time");
-            flight["arrival_time"] = result->getString("arrival_time");
-            flight["status"] = result->getString("status");
-            flight["gate"] = result->isNull("gate") ? nullptr : result->getString("gate");
-
-            if (!result->isNull("base_price")) {
-                flight["base_price"] = result->getDouble("base_price");
-            } else {
-                flight["base_price"] = nullptr;
-            }
+        QueryBatch queries;
+        queries.add("SELECT COUNT(*) as count FROM flights")
+            .add(query).bind(limit).bind(offset);
 
-            flight["aircraft_model"] = result->getString("aircraft_model");
-            flight["registration_number"] = result->getString("registration_number");
+        // A cache hit needs neither the executor nor a connection
+        auto cached = QueryCache::getInstance().lookup(queries.render(), {"flights", "routes", "aircraft", "crews"});
+        if (cached) {
+            return crow::response(200, *cached);
+        }
 
-            if (!result->isNull("crew_name")) {
-                flight["crew_name"] = result->getString("crew_name");
-            } else {
-                flight["crew_name"] = nullptr;
+        // Run the queries on the database executor so slow ones do not hold HTTP workers
+        int userId = get_user_id(req);
+        bool fromPrimary = false; // written by the task; read only after future.get()
+        auto future = DBExecutor::getInstance().submit([=, &fromPrimary]() {
+            // Get database connection
+            auto db = DBConnectionPool::getInstance().getReadConnection(userId);
+            fromPrimary = db.isPrimary();
+
+            // Fetch the total count and the page in one round trip
+            auto batch = db->executeBatch(queries);
+
+            auto countResult = batch.next();
+            countResult->next();
+            int totalCount = countResult->getInt("count");
+
+            auto result = batch.next();
+
+            // Build response JSON
+            json response;
+            json flightsArray = json::array();
+
+            while (result->next()) {
+                json flight;
+                flight["flight_id"] = result->getInt("flight_id");
+                flight["flight_number"] = result->getString("flight_number");
+                flight["origin"] = result->getString("origin");
+                flight["destination"] = result->getString("destination");
+                flight["departure_time"] = result->getString("departure_time");
+                flight["arrival_time"] = result->getString("arrival_time");
+                flight["status"] = result->getString("status");
+                flight["gate"] = result->isNull("gate") ? nullptr : result->getString("gate");
+
+                if (!result->isNull("base_price")) {
+                    flight["base_price"] = result->getDouble("base_price");
+                } else {
+                    flight["base_price"] = nullptr;
+                }
+
+                flight["aircraft_model"] = result->getString("aircraft_model");
+                flight["registration_number"] = result->getString("registration_number");
+
+                if (!result->isNull("crew_name")) {
+                    flight["crew_name"] = result->getString("crew_name");
+                } else {
+                    flight["crew_name"] = nullptr;
+                }
+
+                flightsArray.push_back(flight);
             }
 
-            flightsArray.push_back(flight);
+            response["success"] = true;
+            response["count"] = flightsArray.size();
+            response["pagination"] = {
+                {"page", page},
+                {"limit", limit},
+                {"totalPages", (int)std::ceil((double)totalCount / limit)},
+                {"totalItems", totalCount}
+            };
+            response["data"] = flightsArray;
+
+            return response;
+        });
+
+        json response = future.get();
+
+        // A replica may not have the latest writes yet; only a primary read is safe to keep as current
+        std::string body = response.dump(4);
+        if (fromPrimary) {
+            QueryCache::getInstance().store(cached, body);
         }
 
-        response["success"] = true;
-        response["count"] = flightsArray.size();
-        response["pagination"] = {
-            {"page", page},
-            {"limit", limit},
-            {"totalPages", (int)std::ceil((double)totalCount / limit)},
-            {"totalItems", totalCount}
-        };
-        response["data"] = flightsArray;
-
-        return crow::response(200, response.dump(4));
+        return crow::response(200, body);
+    }
+    catch (const PoolSaturatedError& e) {
+        return overload_error(e);
     }
     catch (const sql::SQLException& e) {
         LOG_ERROR("SQL error in getFlights: " + std::string(e.what()));
@@ -28,8 +28,11 @@ crow::response HealthController::checkHealth() {
 
 crow::response HealthController::checkDatabaseHealth() {
     try {
+        // Served from the background probe's cached status; no database round trip here
         auto& dbPool = DBConnectionPool::getInstance();
         bool dbHealthy = dbPool.checkHealth();
+        auto probe = dbPool.getHealthStatus();
+        auto stats = dbPool.getStats();
 
         json response;
         response["status"] = dbHealthy ? "ok" : "error";
@@ -37,6 +40,49 @@ crow::response HealthController::checkDatabaseHealth() {
         response["service"] = "airline-api";
         response["database"] = dbHealthy ? "connected" : "disconnected";
 
+        response["probe"] = {
+            {"age_ms", probe.ageMs},
+            {"latency_ms", static_cast<double>(probe.latencyUs) / 1000.0},
+            {"stale", probe.stale},
+            {"consecutive_failures", probe.consecutiveFailures}
+        };
+        if (!probe.lastError.empty()) {
+            response["probe"]["error"] = probe.lastError;
+        }
+
+        // Saturation figures so a load balancer can drain this instance before requests time out
+        response["pool"] = {
+            {"size", stats.size},
+            {"max", stats.maxSize},
+            {"leased", stats.leased},
+            {"idle", stats.idle},
+            {"waiters", stats.waiters},
+            {"pending", stats.pending},
+            {"shed", stats.shed},
+            {"limit", stats.limit},
+            {"utilization", stats.limit > 0 ? static_cast<double>(stats.leased) / stats.limit : 0.0}
+        };
+        response["saturated"] = stats.waiters > 0 || stats.leased >= stats.limit;
+
+        // Where the adaptive concurrency limit stands and how it got there
+        auto limiter = dbPool.getLimiterStats();
+        response["pool"]["limiter"] = {
+            {"baseline_ms", limiter.baselineMs},
+            {"last_window_ms", limiter.lastWindowMs},
+            {"increases", limiter.increases},
+            {"decreases", limiter.decreases}
+        };
+
+        // Open means queries are being failed fast until the next probe gets through
+        auto circuit = dbPool.getCircuitStats();
+        response["circuit"] = {
+            {"state", CircuitBreaker::stateName(circuit.state)},
+            {"consecutive_failures", circuit.consecutiveFailures},
+            {"opened", circuit.opened},
+            {"rejected", circuit.rejected},
+            {"retry_in_ms", circuit.retryInMs}
+        };
+
         return crow::response(dbHealthy ? 200 : 503, response.dump(4));
     }
     catch (const std::exception& e) {
@@ -0,0 +1,90 @@
+#include "../../include/database/BulkInsert.h"
+#include <stdexcept>
+
+BulkInsert::BulkInsert(std::string table, std::vector<std::string> columns, size_t maxStatementBytes)
+    : table(std::move(table)), columns(std::move(columns)), maxStatementBytes(maxStatementBytes) {}
+
+BulkInsert& BulkInsert::row() {
+    rows.emplace_back();
+    rows.back().reserve(columns.size());
+    return *this;
+}
+
+BulkInsert& BulkInsert::bind(int value) {
+    return bindLiteral(SqlLiteral::of(static_cast<long long>(value)));
+}
+
+BulkInsert& BulkInsert::bind(long long value) {
+    return bindLiteral(SqlLiteral::of(value));
+}
+
+BulkInsert& BulkInsert::bind(double value) {
+    return bindLiteral(SqlLiteral::of(value));
+}
+
+BulkInsert& BulkInsert::bind(const std::string& value) {
+    return bindLiteral(SqlLiteral::of(value));
+}
+
+BulkInsert& BulkInsert::bindNull() {
+    return bindLiteral("NULL");
+}
+
+BulkInsert& BulkInsert::bindLiteral(std::string literal) {
+    if (rows.empty()) {
+        throw std::invalid_argument("BulkInsert: bind called before row");
+    }
+    if (rows.back().size() >= columns.size()) {
+        throw std::invalid_argument("BulkInsert: too many values bound for a row of " + table);
+    }
+    rows.back().push_back(std::move(literal));
+    return *this;
+}
+
+std::vector<BulkInsert::Chunk> BulkInsert::render(bool singleRows) const {
+    std::string prefix = "INSERT INTO " + table + " (";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        prefix += (i > 0 ? ", " : "") + columns[i];
+    }
+    prefix += ") VALUES ";
+
+    std::vector<Chunk> chunks;
+    std::string sql;
+    size_t firstRow = 0;
+
+    for (size_t r = 0; r < rows.size(); ++r) {
+        const auto& values = rows[r];
+        if (values.size() != columns.size()) {
+            throw std::invalid_argument("BulkInsert: row " + std::to_string(r) + " of " + table + " has " +
+                                        std::to_string(values.size()) + " values for " +
+                                        std::to_string(columns.size()) + " columns");
+        }
+
+        std::string tuple = "(";
+        for (size_t i = 0; i < values.size(); ++i) {
+            tuple += (i > 0 ? ", " : "") + values[i];
+        }
+        tuple += ")";
+
+        // Start a new statement when this row would push the current one over the limit;
+        // a single oversized row still goes out on its own
+        if (!sql.empty() && (singleRows || sql.size() + 2 + tuple.size() > maxStatementBytes)) {
+            chunks.push_back({std::move(sql), firstRow, r - firstRow});
+            sql.clear();
+        }
+
+        if (sql.empty()) {
+            sql = prefix;
+            firstRow = r;
+        } else {
+            sql += ", ";
+        }
+        sql += tuple;
+    }
+
+    if (!sql.empty()) {
+        chunks.push_back({std::move(sql), firstRow, rows.size() - firstRow});
+    }
+
+    return chunks;
+}
@@ -0,0 +1,160 @@
+#include "../../include/database/CircuitBreaker.h"
+#include "../../include/utils/Logger.h"
+#include <algorithm>
+
+CircuitBreaker::CircuitBreaker()
+    : state(State::Closed), consecutiveFailures(0), failureThreshold(5), openDuration(5000), opened(0), rejected(0) {}
+
+bool CircuitBreaker::allowRequest() {
+    if (admit()) {
+        return true;
+    }
+
+    rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool CircuitBreaker::allowProbe() {
+    return admit();
+}
+
+bool CircuitBreaker::probeDue() {
+    if (state.load(std::memory_order_relaxed) == State::Closed) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+
+    switch (state.load(std::memory_order_relaxed)) {
+        case State::Open:
+            return now >= retryAt;
+        case State::HalfOpen:
+            return now - probeStarted >= openDuration;
+        default:
+            return false;
+    }
+}
+
+bool CircuitBreaker::admit() {
+    if (state.load(std::memory_order_relaxed) == State::Closed) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+
+    switch (state.load(std::memory_order_relaxed)) {
+        case State::Closed:
+            return true;
+
+        case State::Open:
+            if (now >= retryAt) {
+                state = State::HalfOpen;
+                probeStarted = now;
+                LOG_INFO("Database circuit breaker half-open, letting a probe through");
+                return true;
+            }
+            break;
+
+        case State::HalfOpen:
+            // A probe that never reported back (e.g. its lease ran no query) must not wedge the breaker
+            if (now - probeStarted >= openDuration) {
+                probeStarted = now;
+                return true;
+            }
+            break;
+    }
+
+    return false;
+}
+
+void CircuitBreaker::recordSuccess() {
+    if (state.load(std::memory_order_relaxed) == State::Closed &&
+        consecutiveFailures.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    switch (state.load(std::memory_order_relaxed)) {
+        case State::Closed:
+            consecutiveFailures = 0;
+            break;
+
+        case State::HalfOpen:
+            consecutiveFailures = 0;
+            state = State::Closed;
+            LOG_INFO("Database circuit breaker closed, database reachable again");
+            break;
+
+        case State::Open:
+            // A request that was already in flight when it opened says nothing about the
+            // database now; only the half-open probe may close it
+            break;
+    }
+}
+
+void CircuitBreaker::recordFailure(const std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+    int failures = ++consecutiveFailures;
+
+    switch (state.load(std::memory_order_relaxed)) {
+        case State::Closed:
+            if (failures >= failureThreshold.load()) {
+                open(now, reason);
+            }
+            break;
+
+        case State::HalfOpen:
+            open(now, reason);
+            break;
+
+        case State::Open:
+            // Requests already in flight when it opened; the open period stands
+            break;
+    }
+}
+
+std::chrono::milliseconds CircuitBreaker::retryIn() {
+    if (isClosed()) {
+        return std::chrono::milliseconds(0);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(retryAt - std::chrono::steady_clock::now());
+    return std::max(std::chrono::milliseconds(0), remaining);
+}
+
+CircuitBreaker::Stats CircuitBreaker::getStats() {
+    long long retry = retryIn().count();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats stats;
+    stats.state = state.load(std::memory_order_relaxed);
+    stats.consecutiveFailures = consecutiveFailures.load(std::memory_order_relaxed);
+    stats.opened = opened;
+    stats.rejected = rejected.load(std::memory_order_relaxed);
+    stats.retryInMs = retry;
+    return stats;
+}
+
+const char* CircuitBreaker::stateName(State state) {
+    switch (state) {
+        case State::Closed: return "closed";
+        case State::Open: return "open";
+        case State::HalfOpen: return "half-open";
+        default: return "unknown";
+    }
+}
+
+void CircuitBreaker::open(std::chrono::steady_clock::time_point now, const std::string& reason) {
+    state = State::Open;
+    retryAt = now + openDuration;
+    opened++;
+
+    LOG_ERROR("Database circuit breaker opened after " + std::to_string(consecutiveFailures.load()) +
+              " consecutive failures (" + reason + "); failing requests fast for " +
+              std::to_string(openDuration.count()) + " ms");
+}
@@ -0,0 +1,100 @@
+#include "../../include/database/ConcurrencyLimiter.h"
+#include "../../include/utils/Logger.h"
+#include <algorithm>
+
+ConcurrencyLimiter::ConcurrencyLimiter()
+    : limit(10), minLimit(1), maxLimit(20), tolerance(2.0), sampleCount(0), sampleTotalUs(0), peakInflight(0),
+      windowEnd(0), baselineUs(0), lastWindowUs(0), increases(0), decreases(0) {}
+
+void ConcurrencyLimiter::configure(int minLimit, int maxLimit, int initialLimit) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    this->minLimit = std::max(1, minLimit);
+    this->maxLimit = std::max(this->minLimit.load(), maxLimit);
+    limit = std::clamp(initialLimit, this->minLimit.load(), this->maxLimit.load());
+
+    sampleCount = 0;
+    sampleTotalUs = 0;
+    peakInflight = 0;
+    windowEnd = 0;
+    baselineUs = 0;
+    lastWindowUs = 0;
+}
+
+void ConcurrencyLimiter::onSample(std::chrono::microseconds elapsed, int inflight) {
+    sampleCount.fetch_add(1, std::memory_order_relaxed);
+    sampleTotalUs.fetch_add(static_cast<uint64_t>(std::max<int64_t>(0, elapsed.count())), std::memory_order_relaxed);
+
+    int peak = peakInflight.load(std::memory_order_relaxed);
+    while (inflight > peak && !peakInflight.compare_exchange_weak(peak, inflight, std::memory_order_relaxed)) {
+    }
+
+    int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+    if (now < windowEnd.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // Whoever sees the window end first closes it; everybody else keeps going
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock() || now < windowEnd.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    int64_t window = std::chrono::duration_cast<std::chrono::steady_clock::duration>(kWindow).count();
+    bool first = windowEnd.load(std::memory_order_relaxed) == 0;
+    windowEnd.store(now + window, std::memory_order_relaxed);
+
+    uint64_t count = sampleCount.exchange(0, std::memory_order_relaxed);
+    uint64_t totalUs = sampleTotalUs.exchange(0, std::memory_order_relaxed);
+    int peakSeen = peakInflight.exchange(0, std::memory_order_relaxed);
+
+    // The first window starts whenever the pool happened to be idle; only use it to start the clock
+    if (!first) {
+        evaluate(count, totalUs, peakSeen);
+    }
+}
+
+void ConcurrencyLimiter::evaluate(uint64_t count, uint64_t totalUs, int peakSeen) {
+    if (count < kMinSamples) {
+        return;
+    }
+
+    double averageUs = static_cast<double>(totalUs) / static_cast<double>(count);
+    lastWindowUs = averageUs;
+    baselineUs = baselineUs == 0 ? averageUs : std::min(averageUs, baselineUs * kBaselineDrift);
+
+    int current = limit.load(std::memory_order_relaxed);
+    int next = current;
+
+    if (averageUs > baselineUs * tolerance.load(std::memory_order_relaxed)) {
+        next = std::max(minLimit.load(), static_cast<int>(current * kBackoff));
+        if (next < current) {
+            decreases++;
+        }
+    } else if (peakSeen * 2 >= current) {
+        // Only grow a limit that is actually being used
+        next = std::min(maxLimit.load(), current + 1);
+        if (next > current) {
+            increases++;
+        }
+    }
+
+    if (next != current) {
+        limit.store(next, std::memory_order_relaxed);
+        LOG_DEBUG("Database concurrency limit " + std::to_string(current) + " -> " + std::to_string(next) +
+                  " (window average " + std::to_string(static_cast<long long>(averageUs)) + " us, baseline " +
+                  std::to_string(static_cast<long long>(baselineUs)) + " us)");
+    }
+}
+
+ConcurrencyLimiter::Stats ConcurrencyLimiter::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Stats stats;
+    stats.limit = limit.load(std::memory_order_relaxed);
+    stats.baselineMs = baselineUs / 1000.0;
+    stats.lastWindowMs = lastWindowUs / 1000.0;
+    stats.increases = increases;
+    stats.decreases = decreases;
+    return stats;
+}
@@ -1,11 +1,21 @@
 #include "../../include/database/DBConnectionPool.h"
+#include "../../include/database/QueryCache.h"
 #include "../../include/utils/Logger.h"
-#include <iostream>
 #include <sstream>
+#include <thread>
+#include <algorithm>
+#include <functional>
 
-DBConnection::DBConnection(std::shared_ptr<sql::Connection> conn) : connection(conn), inUse(false) {}
+DBConnection::DBConnection(std::shared_ptr<sql::Connection> conn, size_t statementCacheSize,
+                           std::shared_ptr<CircuitBreaker> breaker)
+    : connection(conn), breaker(std::move(breaker)), statementCacheCapacity(statementCacheSize), statementCacheHits(0), statementCacheMisses(0),
+      statementInfo(std::make_shared<StatementInfoMap>()),
+      lastUsed(std::chrono::steady_clock::now()), lastChecked(lastUsed) {}
 
 DBConnection::~DBConnection() {
+    // Statements must be released before the connection they belong to is closed
+    clearStatementCache();
+
     try {
         if (connection) {
             connection->close();
@@ -21,10 +31,17 @@ DBConnection::~DBConnection() {
 
 std::unique_ptr<sql::ResultSet> DBConnection::executeQuery(const std::string& query) {
     try {
+        StatementInfo info{QueryStats::getInstance().entryFor(query), 0, {}};
+        auto started = std::chrono::steady_clock::now();
+
         std::unique_ptr<sql::Statement> stmt(connection->createStatement());
-        return std::unique_ptr<sql::ResultSet>(stmt->executeQuery(query));
+        std::unique_ptr<sql::ResultSet> result(stmt->executeQuery(query));
+        recordExecution(&info, started, rowCount(result.get()));
+        recordSuccess();
+        return result;
     }
     catch (const sql::SQLException& e) {
+        recordFailure(e);
         std::stringstream ss;
         ss << "SQL Error in executeQuery: " << e.what() << ". Query: " << query;
         LOG_ERROR(ss.str());
@@ -32,11 +49,16 @@ std::unique_ptr<sql::ResultSet> DBConnection::executeQuery(const std::string& qu
     }
 }
 
-std::unique_ptr<sql::ResultSet> DBConnection::executeQuery(std::unique_ptr<sql::PreparedStatement>& stmt) {
+std::unique_ptr<sql::ResultSet> DBConnection::executeQuery(const std::shared_ptr<sql::PreparedStatement>& stmt) {
     try {
-        return std::unique_ptr<sql::ResultSet>(stmt->executeQuery());
+        auto started = std::chrono::steady_clock::now();
+        std::unique_ptr<sql::ResultSet> result(stmt->executeQuery());
+        recordExecution(infoFor(stmt.get()), started, rowCount(result.get()));
+        recordSuccess();
+        return result;
     }
     catch (const sql::SQLException& e) {
+        recordFailure(e);
         std::stringstream ss;
         ss << "SQL Error in executeQuery with prepared statement: " << e.what();
         LOG_ERROR(ss.str());
@@ -46,10 +68,18 @@ std::unique_ptr<sql::ResultSet> DBConnection::executeQuery(std::unique_ptr<sql::
 
 int DBConnection::executeUpdate(const std::string& query) {
     try {
+        StatementInfo info{QueryStats::getInstance().entryFor(query), 0, {}};
+        auto started = std::chrono::steady_clock::now();
+
         std::unique_ptr<sql::Statement> stmt(connection->createStatement());
-        return stmt->executeUpdate(query);
+        int affected = stmt->executeUpdate(query);
+        recordExecution(&info, started, affected);
+        recordSuccess();
+        invalidateWrites(QueryCache::tablesWritten(query));
+        return affected;
     }
     catch (const sql::SQLException& e) {
+        recordFailure(e);
         std::stringstream ss;
         ss << "SQL Error in executeUpdate: " << e.what() << ". Query: " << query;
         LOG_ERROR(ss.str());
@@ -57,11 +87,20 @@ int DBConnection::executeUpdate(const std::string& query) {
     }
 }
 
-int DBConnection::executeUpdate(std::unique_ptr<sql::PreparedStatement>& stmt) {
+int DBConnection::executeUpdate(const std::shared_ptr<sql::PreparedStatement>& stmt) {
     try {
-        return stmt->executeUpdate();
+        auto started = std::chrono::steady_clock::now();
+        int affected = stmt->executeUpdate();
+        const StatementInfo* info = infoFor(stmt.get());
+        recordExecution(info, started, affected);
+        recordSuccess();
+        if (info) {
+            invalidateWrites(info->writes);
+        }
+        return affected;
     }
     catch (const sql::SQLException& e) {
+        recordFailure(e);
         std::stringstream ss;
         ss << "SQL Error in executeUpdate with prepared statement: " << e.what();
         LOG_ERROR(ss.str());
@@ -69,11 +108,210 @@ int DBConnection::executeUpdate(std::unique_ptr<sql::PreparedStatement>& stmt) {
     }
 }
 
-std::unique_ptr<sql::PreparedStatement> DBConnection::prepareStatement(const std::string& query) {
+BatchResult DBConnection::executeBatch(const QueryBatch& batch) {
+    std::string query = batch.render();
+    try {
+        // Timed as a whole: the batch is one round trip and one fingerprint
+        StatementInfo info{QueryStats::getInstance().entryFor(query), 0, {}};
+        auto started = std::chrono::steady_clock::now();
+
+        std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+        bool hasResultSet = stmt->execute(query);
+        recordExecution(&info, started, 0);
+        recordSuccess();
+        invalidateWrites(QueryCache::tablesWritten(query));
+        return BatchResult(std::move(stmt), hasResultSet);
+    }
+    catch (const sql::SQLException& e) {
+        recordFailure(e);
+        std::stringstream ss;
+        ss << "SQL Error in executeBatch: " << e.what() << ". Query: " << query;
+        LOG_ERROR(ss.str());
+        throw;
+    }
+}
+
+std::vector<int64_t> DBConnection::executeBulkInsert(const BulkInsert& insert) {
+    std::vector<int64_t> keys;
+    keys.reserve(insert.size());
+    const auto written = QueryCache::tablesWritten("INSERT INTO " + insert.getTable());
+
+    // Without consecutive keys, one statement per row is the only way to learn every row's key
+    bool singleRows = !consecutiveInsertKeys();
+
+    for (const auto& chunk : insert.render(singleRows)) {
+        try {
+            StatementInfo info{QueryStats::getInstance().entryFor(chunk.sql), 0, {}};
+            auto started = std::chrono::steady_clock::now();
+
+            std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+            int affected = stmt->executeUpdate(chunk.sql, sql::Statement::RETURN_GENERATED_KEYS);
+            recordExecution(&info, started, affected);
+            recordSuccess();
+            invalidateWrites(written);
+
+            // InnoDB hands a multi-row INSERT consecutive keys (autoinc lock modes 0 and 1, with an
+            // increment of 1), so any the driver does not list follow on from the last one it does
+            std::unique_ptr<sql::ResultSet> generated(stmt->getGeneratedKeys());
+            size_t listed = 0;
+            while (generated && listed < chunk.rowCount && generated->next()) {
+                keys.push_back(generated->getLong(1));
+                listed++;
+            }
+            for (; listed < chunk.rowCount; ++listed) {
+                keys.push_back(keys.size() > chunk.firstRow && keys.back() != 0 ? keys.back() + 1 : 0);
+            }
+        }
+        catch (const sql::SQLException& e) {
+            recordFailure(e);
+            std::stringstream ss;
+            ss << "SQL Error in executeBulkInsert: " << e.what() << ". Rows " << chunk.firstRow
+               << "-" << chunk.firstRow + chunk.rowCount - 1;
+            LOG_ERROR(ss.str());
+            throw;
+        }
+    }
+
+    return keys;
+}
+
+bool DBConnection::consecutiveInsertKeys() {
+    if (insertKeyOrder != KeyOrder::Unknown) {
+        return insertKeyOrder == KeyOrder::Consecutive;
+    }
+
+    insertKeyOrder = KeyOrder::Unordered;
+    try {
+        std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+        std::unique_ptr<sql::ResultSet> result(
+            stmt->executeQuery("SELECT @@auto_increment_increment, @@innodb_autoinc_lock_mode"));
+
+        if (result && result->next()) {
+            int increment = result->getInt(1);
+            int lockMode = result->getInt(2);
+
+            if (increment == 1 && (lockMode == 0 || lockMode == 1)) {
+                insertKeyOrder = KeyOrder::Consecutive;
+            } else {
+                static std::atomic<bool> warned(false);
+                if (!warned.exchange(true)) {
+                    LOG_WARNING("auto_increment_increment=" + std::to_string(increment) +
+                                ", innodb_autoinc_lock_mode=" + std::to_string(lockMode) +
+                                ": multi-row inserts do not get consecutive keys, bulk inserts go one row per statement");
+                }
+            }
+        }
+    }
+    catch (const sql::SQLException& e) {
+        LOG_WARNING("Could not read auto-increment settings, bulk inserts go one row per statement: " +
+                    std::string(e.what()));
+    }
+
+    return insertKeyOrder == KeyOrder::Consecutive;
+}
+
+Transaction DBConnection::beginTransaction(IsolationLevel isolation) {
+    Transaction transaction(connection, isolation);
+
+    // Readers on other connections can cache the pre-transaction rows between a write and
+    // the commit, so everything written is invalidated once more when the transaction ends
+    auto state = std::make_shared<TransactionState>();
+    transactionState = state;
+    transaction.setOnEnd([state](bool clean) {
+        state->open = false;
+        state->failed = !clean;
+        QueryCache::getInstance().invalidate(state->tables);
+    });
+
+    return transaction;
+}
+
+std::shared_ptr<sql::PreparedStatement> DBConnection::prepareStatement(const std::string& query) {
+    return prepareCached(query, false);
+}
+
+std::shared_ptr<sql::PreparedStatement> DBConnection::prepareInsert(const std::string& query) {
+    return prepareCached(query, true);
+}
+
+int64_t DBConnection::executeInsert(const std::shared_ptr<sql::PreparedStatement>& stmt) {
+    try {
+        auto started = std::chrono::steady_clock::now();
+        int affected = stmt->executeUpdate();
+        const StatementInfo* info = infoFor(stmt.get());
+        recordExecution(info, started, affected);
+        recordSuccess();
+        if (info) {
+            invalidateWrites(info->writes);
+        }
+
+        // The key comes back in the OK packet of the insert, no extra query is sent
+        std::unique_ptr<sql::ResultSet> keys(stmt->getGeneratedKeys());
+        if (keys && keys->next()) {
+            return keys->getLong(1);
+        }
+        return 0;
+    }
+    catch (const sql::SQLException& e) {
+        recordFailure(e);
+        std::stringstream ss;
+        ss << "SQL Error in executeInsert with prepared statement: " << e.what();
+        LOG_ERROR(ss.str());
+        throw;
+    }
+}
+
+std::shared_ptr<sql::PreparedStatement> DBConnection::prepareCached(const std::string& query, bool generatedKeys) {
+    // Statements prepared for generated keys are cached apart from plain ones
+    const std::string key = generatedKeys ? "[keys] " + query : query;
+
     try {
-        return std::unique_ptr<sql::PreparedStatement>(connection->prepareStatement(query));
+        auto it = statementCacheIndex.find(key);
+        if (it != statementCacheIndex.end()) {
+            statementCacheHits.fetch_add(1, std::memory_order_relaxed);
+
+            // Move to the front of the LRU list and hand it back without old bindings
+            statementCache.splice(statementCache.begin(), statementCache, it->second);
+            auto stmt = it->second->second;
+            stmt->clearParameters();
+            return stmt;
+        }
+
+        statementCacheMisses.fetch_add(1, std::memory_order_relaxed);
+
+        // The deleter drops the statement's stats registration together with the statement
+        std::shared_ptr<StatementInfoMap> info = statementInfo;
+        std::shared_ptr<sql::PreparedStatement> stmt(generatedKeys
+            ? connection->prepareStatement(query, sql::Statement::RETURN_GENERATED_KEYS)
+            : connection->prepareStatement(query),
+            [info](sql::PreparedStatement* p) {
+                info->erase(p);
+                delete p;
+            });
+
+        (*statementInfo)[stmt.get()] = {
+            QueryStats::getInstance().entryFor(query),
+            QueryStats::countParameters(query),
+            QueryCache::tablesWritten(query)
+        };
+
+        if (statementCacheCapacity == 0) {
+            return stmt;
+        }
+
+        statementCache.emplace_front(key, stmt);
+        statementCacheIndex[key] = statementCache.begin();
+
+        // Evict the least recently used statement; callers still holding it keep it alive
+        if (statementCache.size() > statementCacheCapacity) {
+            statementCacheIndex.erase(statementCache.back().first);
+            statementCache.pop_back();
+        }
+
+        return stmt;
     }
     catch (const sql::SQLException& e) {
+        recordFailure(e);
         std::stringstream ss;
         ss << "SQL Error in prepareStatement: " << e.what() << ". Query: " << query;
         LOG_ERROR(ss.str());
@@ -81,8 +319,168 @@ std::unique_ptr<sql::PreparedStatement> DBConnection::prepareStatement(const std
     }
 }
 
+const DBConnection::StatementInfo* DBConnection::infoFor(const sql::PreparedStatement* stmt) const {
+    auto it = statementInfo->find(stmt);
+    return it != statementInfo->end() ? &it->second : nullptr;
+}
+
+void DBConnection::recordExecution(const StatementInfo* info, std::chrono::steady_clock::time_point started, uint64_t rows) {
+    // Statements prepared outside this connection's cache are not tracked
+    if (!info) {
+        return;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    QueryStats::getInstance().record(info->stats, elapsed, rows, info->parameterCount);
+}
+
+void DBConnection::invalidateWrites(const std::vector<std::string>& tables) {
+    if (tables.empty()) {
+        return;
+    }
+
+    QueryCache::getInstance().invalidate(tables);
+
+    if (transactionState && transactionState->open) {
+        for (const auto& table : tables) {
+            if (std::find(transactionState->tables.begin(), transactionState->tables.end(), table) ==
+                transactionState->tables.end()) {
+                transactionState->tables.push_back(table);
+            }
+        }
+    }
+}
+
+void DBConnection::recordFailure(const sql::SQLException& e) const {
+    if (!breaker) {
+        return;
+    }
+
+    // SQLSTATE class 08 is a connection exception; the client error codes cover the driver
+    // failing to reach the server or losing it mid-query. Errors the server itself returns
+    // (syntax, constraints, deadlocks) say nothing about whether the database is up.
+    static const int connectionErrors[] = {
+        1040, // too many connections
+        1053, // server shutdown in progress
+        2002, // can't connect through socket
+        2003, // can't connect to server
+        2005, // unknown host
+        2006, // server has gone away
+        2013, // lost connection during query
+        2055  // lost connection at system error
+    };
+
+    std::string state = std::string(e.getSQLState().c_str());
+    int code = e.getErrorCode();
+    bool connectionFailure = state.rfind("08", 0) == 0 ||
+        std::find(std::begin(connectionErrors), std::end(connectionErrors), code) != std::end(connectionErrors);
+
+    if (connectionFailure) {
+        breaker->recordFailure(std::string(e.what()));
+    }
+}
+
+uint64_t DBConnection::rowCount(const sql::ResultSet* result) {
+    if (!result) {
+        return 0;
+    }
+
+    // Streaming result sets only know about the rows fetched so far
+    try {
+        return result->rowsCount();
+    }
+    catch (const sql::SQLException&) {
+        return 0;
+    }
+}
+
+void DBConnection::clearStatementCache() {
+    statementCacheIndex.clear();
+    statementCache.clear();
+}
+
+bool DBConnection::ping() {
+    try {
+        return connection && connection->isValid(2);
+    }
+    catch (const sql::SQLException& e) {
+        LOG_WARNING("Database connection ping failed: " + std::string(e.what()));
+        return false;
+    }
+}
+
+// ConnectionLease implementation
+ConnectionLease::ConnectionLease(DBConnectionPool* pool, std::shared_ptr<DBConnection> conn,
+                                 std::shared_ptr<AffineSlot> slot)
+    : pool(pool), conn(std::move(conn)), acquiredAt(std::chrono::steady_clock::now()), slot(std::move(slot)) {
+    if (this->pool && this->conn) {
+        this->pool->leasedConnections++;
+    }
+}
+
+ConnectionLease::~ConnectionLease() {
+    release();
+}
+
+ConnectionLease::ConnectionLease(ConnectionLease&& other) noexcept
+    : pool(other.pool), conn(std::move(other.conn)), writerId(other.writerId), acquiredAt(other.acquiredAt),
+      slot(std::move(other.slot)) {
+    other.pool = nullptr;
+    other.writerId = 0;
+}
+
+ConnectionLease& ConnectionLease::operator=(ConnectionLease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        conn = std::move(other.conn);
+        writerId = other.writerId;
+        acquiredAt = other.acquiredAt;
+        slot = std::move(other.slot);
+        other.pool = nullptr;
+        other.writerId = 0;
+    }
+    return *this;
+}
+
+void ConnectionLease::release() {
+    if (pool && conn) {
+        pool->recordLeaseTime(acquiredAt, pool->leasedConnections.fetch_sub(1));
+        // The read-your-writes window starts once the write is finished
+        if (writerId != 0) {
+            pool->recordWrite(writerId);
+        }
+        if (slot) {
+            pool->parkAffine(slot, conn);
+        } else {
+            pool->releaseConnection(conn);
+        }
+    }
+    conn.reset();
+    slot.reset();
+    pool = nullptr;
+    writerId = 0;
+}
+
+bool ConnectionLease::isPrimary() const {
+    // Replica pools are owned by the primary; only the primary is the singleton
+    return pool == &DBConnectionPool::getInstance();
+}
+
 // DBConnectionPool implementation
-DBConnectionPool::DBConnectionPool() : initialized(false) {}
+DBConnectionPool::DBConnectionPool()
+    : waiters(0), maxWaiters(64), queuePolicy(QueuePolicy::CoDel), queueTarget(50), queueInterval(100), shedCount(0),
+      adaptiveLimit(false), breaker(std::make_shared<CircuitBreaker>()),
+      maxPoolSize(20), acquireTimeout(5000), pendingConnections(0), statementCacheSize(64),
+      warmupQuorum(1), minPoolSize(2), idleTimeout(60000), keepaliveInterval(30000), maintenanceInterval(1000), recentWaits(0),
+      stopHealthProbe(false), healthProbeInterval(1000), stopMaintenance(false), port(3306), initialized(false), nextReplica(0), leastLoadedReplicas(false),
+      leasedConnections(0), readYourWritesWindow(0), threadAffinity(false), affinityIdleTimeout(5000) {
+    // One free-list shard per hardware thread keeps checkout contention per shard low
+    unsigned int shardCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < shardCount; ++i) {
+        shards.push_back(std::make_unique<FreeListShard>());
+    }
+}
 
 DBConnectionPool::~DBConnectionPool() {
     cleanup();
@@ -96,206 +494,1084 @@ bool DBConnectionPool::initialize(
     int port,
     int poolSize
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
+    try {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
 
-    if (initialized) {
-        return true;
-    }
+            if (initialized) {
+                return true;
+            }
 
-    try {
-        // Store connection parameters
-        this->host = host;
-        this->user = user;
-        this->password = password;
-        this->database = database;
-        this->port = port;
-
-        // Get the MariaDB driver
-        // Note: MariaDB's driver should not be deleted, so we use a shared_ptr with a no-op deleter
-        sql::Driver* rawDriver = sql::mariadb::get_driver_instance();
-        driver = std::shared_ptr<sql::Driver>(rawDriver, [](sql::Driver*) {
-            // No-op deleter because driver instance is managed by MariaDB internally
-        });
+            // Store connection parameters
+            this->host = host;
+            this->user = user;
+            this->password = password;
+            this->database = database;
+            this->port = port;
 
-        // Create the initial pool of connections
-        for (int i = 0; i < poolSize; ++i) {
-            auto conn = createConnection();
-            if (conn) {
-                connections.push_back(std::make_shared<DBConnection>(conn));
+            // Get the MariaDB driver
+            // Note: MariaDB's driver should not be deleted, so we use a shared_ptr with a no-op deleter
+            sql::Driver* rawDriver = sql::mariadb::get_driver_instance();
+            driver = std::shared_ptr<sql::Driver>(rawDriver, [](sql::Driver*) {
+                // No-op deleter because driver instance is managed by MariaDB internally
+            });
+
+            limiter.configure(minPoolSize, maxPoolSize, poolSize);
+        }
+
+        // Open the initial connections concurrently and continue as soon as the quorum is up;
+        // the rest join the pool in the background as they connect
+        int target = std::max(1, std::min(poolSize, maxPoolSize));
+        int quorum = std::max(1, std::min(warmupQuorum, target));
+        auto state = std::make_shared<WarmupState>();
+        state->started = std::chrono::steady_clock::now();
+        state->target = target;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingConnections += target;
+        }
+
+        for (int i = 0; i < target; ++i) {
+            try {
+                warmupThreads.emplace_back(&DBConnectionPool::warmupConnection, this, state);
+            }
+            catch (const std::system_error& e) {
+                // Attempts that never started count as failed, so the wait below still ends
+                LOG_ERROR("Could not start database warm-up thread: " + std::string(e.what()));
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    pendingConnections -= target - i;
+                }
+                std::lock_guard<std::mutex> stateLock(state->mutex);
+                state->failed += target - i;
+                break;
             }
         }
 
-        if (connections.empty()) {
-            LOG_ERROR("Failed to create any database connections");
+        std::unique_lock<std::mutex> stateLock(state->mutex);
+        state->cv.wait(stateLock, [&] {
+            return state->connected >= quorum || state->connected + state->failed >= target;
+        });
+
+        auto quorumMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - state->started).count();
+
+        if (state->connected == 0) {
+            LOG_ERROR("Failed to create any database connections (" + std::to_string(state->failed) +
+                          " attempts failed in " + std::to_string(quorumMs) + " ms)");
+            stateLock.unlock();
+            joinWarmupThreads();
             return false;
         }
 
-        initialized = true;
+        if (state->connected < quorum) {
+            LOG_WARNING("Database pool warm-up quorum of " + std::to_string(quorum) + " not reached, continuing with " +
+                            std::to_string(state->connected) + " connections");
+        }
+
+        LOG_INFO("Database pool warm-up: " + std::to_string(state->connected) + "/" + std::to_string(target) +
+                     " connected in " + std::to_string(quorumMs) + " ms (quorum " + std::to_string(quorum) +
+                     ", fastest connect " + std::to_string(state->fastestMs) + " ms, slowest " +
+                     std::to_string(state->slowestMs) + " ms, " + std::to_string(state->failed) + " failed)");
+
+        int connected = state->connected;
+        stateLock.unlock();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            initialized = true;
+        }
+
+        startMaintenance();
+        startHealthProbe();
+
         LOG_INFO("Database connection pool initialized with " +
-                     std::to_string(connections.size()) + " connections");
+                     std::to_string(connected) + " connections");
         return true;
     }
     catch (const sql::SQLException& e) {
         std::stringstream ss;
         ss << "SQL Error initializing connection pool: " << e.what();
         LOG_ERROR(ss.str());
+        joinWarmupThreads();
         return false;
     }
     catch (const std::exception& e) {
         LOG_ERROR("Error initializing connection pool: " + std::string(e.what()));
+        joinWarmupThreads();
         return false;
     }
 }
 
-std::shared_ptr<DBConnection> DBConnectionPool::getConnection() {
-    std::lock_guard<std::mutex> lock(mutex);
+void DBConnectionPool::joinWarmupThreads() {
+    for (auto& thread : warmupThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    warmupThreads.clear();
+}
+
+void DBConnectionPool::warmupConnection(std::shared_ptr<WarmupState> state) {
+    auto started = std::chrono::steady_clock::now();
+
+    // Like keepalive pings, warm-up connects only count towards a closed breaker
+    bool reporting = breaker->isClosed();
+
+    std::shared_ptr<sql::Connection> newConn;
+    try {
+        newConn = createConnection();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error opening database connection during warm-up: " + std::string(e.what()));
+    }
+
+    if (reporting && newConn) {
+        breaker->recordSuccess();
+    } else if (reporting) {
+        breaker->recordFailure("warm-up connect failed");
+    }
+
+    long long connectMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        --pendingConnections;
+
+        if (newConn) {
+            auto conn = std::make_shared<DBConnection>(newConn, statementCacheSize, breaker);
+            connections.push_back(conn);
+            pushIdle(conn);
+            wakeWaiters();
+        }
+    }
+
+    std::lock_guard<std::mutex> stateLock(state->mutex);
+    if (newConn) {
+        ++state->connected;
+        state->fastestMs = state->connected == 1 ? connectMs : std::min(state->fastestMs, connectMs);
+        state->slowestMs = std::max(state->slowestMs, connectMs);
+    } else {
+        ++state->failed;
+    }
+
+    // Report the background part of the warm-up once the last attempt has finished
+    if (state->connected + state->failed == state->target) {
+        auto totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - state->started).count();
+        LOG_INFO("Database pool warm-up finished in " + std::to_string(totalMs) + " ms: " +
+                     std::to_string(state->connected) + " connected, " + std::to_string(state->failed) +
+                     " failed, slowest connect " + std::to_string(state->slowestMs) + " ms");
+    }
+
+    state->cv.notify_all();
+}
+
+size_t DBConnectionPool::homeShard() const {
+    static thread_local size_t threadHash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return threadHash % shards.size();
+}
 
+std::shared_ptr<DBConnection> DBConnectionPool::tryAcquireIdle(bool blocking) {
+    size_t home = homeShard();
+
+    for (size_t i = 0; i < shards.size(); ++i) {
+        auto& shard = *shards[(home + i) % shards.size()];
+
+        // On the fast path only wait for our own shard; skip busy shards when stealing
+        std::unique_lock<std::mutex> shardLock(shard.mutex, std::defer_lock);
+        if (blocking || i == 0) {
+            shardLock.lock();
+        } else if (!shardLock.try_lock()) {
+            continue;
+        }
+
+        if (!shard.idle.empty()) {
+            auto conn = std::move(shard.idle.back());
+            shard.idle.pop_back();
+            return conn;
+        }
+    }
+
+    return nullptr;
+}
+
+void DBConnectionPool::pushIdle(std::shared_ptr<DBConnection> conn) {
+    auto& shard = *shards[homeShard()];
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    shard.idle.push_back(std::move(conn));
+}
+
+ConnectionLease DBConnectionPool::getConnection() {
     if (!initialized) {
         throw std::runtime_error("Database connection pool not initialized");
     }
 
-    // Find an available connection
-    for (auto& conn : connections) {
-        if (!conn->inUse) {
-            conn->inUse = true;
-            return conn;
+    // While the database is marked down, fail at once instead of tying the caller up in connect timeouts
+    if (!breaker->allowRequest()) {
+        auto retrySeconds = std::chrono::duration_cast<std::chrono::seconds>(breaker->retryIn()).count() + 1;
+        throw PoolSaturatedError(PoolSaturatedError::Reason::CircuitOpen, "Database circuit breaker is open",
+                                 static_cast<int>(retrySeconds));
+    }
+
+    if (!threadAffinity) {
+        return acquireShared();
+    }
+
+    auto slot = affineSlot();
+    std::unique_lock<std::mutex> slotLock(slot->mutex);
+
+    // A second lease on the same thread, or a slot the pool has closed, goes through the shared pool
+    if (slot->inUse || slot->pool != this) {
+        slotLock.unlock();
+        return acquireShared();
+    }
+
+    if (slot->conn) {
+        slot->inUse = true;
+        return ConnectionLease(this, slot->conn, slot);
+    }
+
+    // First use on this thread, or the previous connection was reclaimed while idle
+    slotLock.unlock();
+    ConnectionLease lease = acquireShared();
+    slotLock.lock();
+
+    if (slot->pool == this) {
+        slot->conn = lease.conn;
+        slot->inUse = true;
+        lease.slot = slot;
+    }
+    return lease;
+}
+
+ConnectionLease DBConnectionPool::acquireShared() {
+    // Fast path: pop an idle connection without touching the pool-wide mutex
+    if (underLimit()) {
+        if (auto conn = tryAcquireIdle(false)) {
+            return ConnectionLease(this, conn);
         }
     }
 
-    // If all connections are in use, create a new one
-    try {
-        auto newConn = createConnection();
-        if (!newConn) {
-            throw std::runtime_error("Failed to create a new database connection");
+    return acquireSlow();
+}
+
+std::shared_ptr<AffineSlot> DBConnectionPool::affineSlot() {
+    // Slots of the pools this thread has used; their connections go back when the thread exits
+    struct ThreadSlots {
+        std::vector<std::shared_ptr<AffineSlot>> slots;
+
+        ~ThreadSlots() {
+            for (auto& slot : slots) {
+                std::lock_guard<std::mutex> slotLock(slot->mutex);
+                if (slot->pool && slot->conn && !slot->inUse) {
+                    slot->pool->releaseConnection(slot->conn);
+                }
+                slot->conn.reset();
+                slot->pool = nullptr;
+            }
+        }
+    };
+    static thread_local ThreadSlots local;
+
+    for (auto& slot : local.slots) {
+        if (slot->owner == this) {
+            return slot;
         }
+    }
 
-        auto conn = std::make_shared<DBConnection>(newConn);
-        conn->inUse = true;
-        connections.push_back(conn);
+    auto slot = std::make_shared<AffineSlot>();
+    slot->owner = this;
+    slot->pool = this;
+    local.slots.push_back(slot);
 
-        LOG_INFO("Created a new database connection. Pool size: " +
-                     std::to_string(connections.size()));
+    std::lock_guard<std::mutex> lock(affineMutex);
+    affineSlots.push_back(slot);
+    return slot;
+}
+
+void DBConnectionPool::parkAffine(const std::shared_ptr<AffineSlot>& slot, const std::shared_ptr<DBConnection>& conn) {
+    // The next request on this thread must not inherit an open transaction either
+    bool reusable = initialized && resetSession(conn);
 
-        return conn;
+    {
+        std::lock_guard<std::mutex> slotLock(slot->mutex);
+        slot->inUse = false;
+
+        if (!reusable) {
+            slot->conn.reset();
+            return;
+        }
+
+        // Keep it unless somebody is blocked waiting for a connection
+        if (slot->pool == this && waiters.load() == 0) {
+            conn->lastUsed = std::chrono::steady_clock::now();
+            return;
+        }
+
+        slot->conn.reset();
     }
-    catch (const std::exception& e) {
-        LOG_ERROR("Error creating a new database connection: " + std::string(e.what()));
-        throw;
+
+    releaseConnection(conn);
+}
+
+void DBConnectionPool::reclaimAffine(std::chrono::steady_clock::time_point now) {
+    std::vector<std::shared_ptr<DBConnection>> reclaimed;
+
+    // While callers are blocked on an exhausted pool, every parked connection is fair game
+    bool starved = waiters.load() > 0;
+
+    {
+        std::lock_guard<std::mutex> lock(affineMutex);
+
+        for (auto it = affineSlots.begin(); it != affineSlots.end();) {
+            auto& slot = *it;
+
+            // A slot whose thread is in the middle of checkout is simply looked at next time
+            std::unique_lock<std::mutex> slotLock(slot->mutex, std::try_to_lock);
+            if (!slotLock) {
+                ++it;
+                continue;
+            }
+
+            // The thread has exited and already returned its connection
+            if (!slot->pool) {
+                slotLock.unlock();
+                it = affineSlots.erase(it);
+                continue;
+            }
+
+            // Connections held this way are always recently used, so they never need a keepalive ping
+            if (slot->conn && !slot->inUse && (starved || now - slot->conn->lastUsed >= affinityIdleTimeout)) {
+                reclaimed.push_back(std::move(slot->conn));
+                slot->conn.reset();
+            }
+            ++it;
+        }
+    }
+
+    for (auto& conn : reclaimed) {
+        releaseConnection(conn);
     }
 }
 
-// Completely rewritten checkHealth method for src/database/DBConnectionPool.cpp
-bool DBConnectionPool::checkHealth() {
-    std::shared_ptr<DBConnection> conn = nullptr;
+void DBConnectionPool::releaseAffineSlots() {
+    std::lock_guard<std::mutex> lock(affineMutex);
+
+    // Connections in use are dropped by their lease, since the slot no longer points at the pool
+    for (auto& slot : affineSlots) {
+        std::lock_guard<std::mutex> slotLock(slot->mutex);
+        if (!slot->inUse) {
+            slot->conn.reset();
+        }
+        slot->pool = nullptr;
+    }
+    affineSlots.clear();
+}
+
+ConnectionLease DBConnectionPool::getWriteConnection(int userId) {
+    ConnectionLease lease = getConnection();
+    if (userId != 0 && readYourWritesWindow.count() > 0 && !replicas.empty()) {
+        lease.writerId = userId;
+    }
+    return lease;
+}
+
+ConnectionLease DBConnectionPool::getReadConnection(int userId) {
+    if (replicas.empty() || (userId != 0 && wroteRecently(userId))) {
+        return getConnection();
+    }
+
+    DBConnectionPool* replica = pickReplica();
+    if (!replica) {
+        return getConnection();
+    }
 
     try {
-        // First, check if we're initialized
+        return replica->getConnection();
+    }
+    catch (const std::exception& e) {
+        // A lagging or unreachable replica should not fail reads the primary can serve
+        LOG_WARNING("Read replica " + replica->host + ":" + std::to_string(replica->port) +
+                    " unavailable, reading from primary: " + std::string(e.what()));
+        return getConnection();
+    }
+}
+
+DBConnectionPool* DBConnectionPool::pickReplica() {
+    DBConnectionPool* best = nullptr;
+
+    // A replica marked down gets one request as its half-open probe once its open period is
+    // over; the replica's own allowRequest lets exactly one through and a loser of that race
+    // falls back to the primary
+    for (auto& replica : replicas) {
+        if (replica->initialized && !replica->breaker->isClosed() && replica->breaker->probeDue()) {
+            return replica.get();
+        }
+    }
+
+    if (leastLoadedReplicas) {
+        for (auto& replica : replicas) {
+            if (!replica->initialized || !replica->breaker->isClosed()) {
+                continue;
+            }
+            if (!best || replica->leasedConnections < best->leasedConnections) {
+                best = replica.get();
+            }
+        }
+        return best;
+    }
+
+    // Round-robin, skipping replicas that have been shut down or are marked down
+    size_t start = nextReplica.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < replicas.size(); ++i) {
+        auto& replica = replicas[(start + i) % replicas.size()];
+        if (replica->initialized && replica->breaker->isClosed()) {
+            return replica.get();
+        }
+    }
+    return nullptr;
+}
+
+void DBConnectionPool::recordWrite(int userId) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(recentWritersMutex);
+    recentWriters[userId] = now;
+
+    // Drop expired entries now and then so the map only holds active writers
+    if (recentWriters.size() > 1024) {
+        for (auto it = recentWriters.begin(); it != recentWriters.end();) {
+            if (now - it->second > readYourWritesWindow) {
+                it = recentWriters.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+bool DBConnectionPool::wroteRecently(int userId) {
+    if (readYourWritesWindow.count() <= 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(recentWritersMutex);
+    auto it = recentWriters.find(userId);
+    if (it == recentWriters.end()) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() - it->second > readYourWritesWindow) {
+        recentWriters.erase(it);
+        return false;
+    }
+    return true;
+}
+
+bool DBConnectionPool::addReplica(const std::string& host, const std::string& user, const std::string& password,
+                                  const std::string& database, int port, int poolSize) {
+    std::unique_ptr<DBConnectionPool> replica(new DBConnectionPool());
+    replica->setMaxPoolSize(maxPoolSize);
+    replica->setMinPoolSize(minPoolSize);
+    replica->setAcquireTimeout(static_cast<int>(acquireTimeout.count()));
+    replica->setStatementCacheSize(statementCacheSize);
+    replica->setWarmupQuorum(warmupQuorum);
+    replica->setIdleTimeout(static_cast<int>(idleTimeout.count()));
+    replica->setMaxWaiters(maxWaiters.load());
+    replica->queuePolicy = queuePolicy;
+    replica->setQueueTarget(static_cast<int>(queueTarget.count()));
+    replica->setQueueInterval(static_cast<int>(queueInterval.count()));
+    replica->setAdaptiveLimit(adaptiveLimit);
+    replica->setAdaptiveLimitTolerance(limiter.getTolerance());
+    replica->setCircuitBreaker(breaker->getFailureThreshold(), breaker->getOpenDuration());
+    replica->setThreadAffinity(threadAffinity);
+    replica->setAffinityIdleTimeout(static_cast<int>(affinityIdleTimeout.count()));
+    replica->setHealthProbeInterval(static_cast<int>(healthProbeInterval.count()));
+
+    if (!replica->initialize(host, user, password, database, port, poolSize)) {
+        LOG_ERROR("Failed to initialize read replica " + host + ":" + std::to_string(port));
+        return false;
+    }
+
+    replicas.push_back(std::move(replica));
+    LOG_INFO("Read replica " + host + ":" + std::to_string(port) + " added (" +
+             std::to_string(replicas.size()) + " total)");
+    return true;
+}
+
+ConnectionLease DBConnectionPool::acquireSlow() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    auto deadline = std::chrono::steady_clock::now() + acquireTimeout;
+    Waiter waiter;
+    bool handedOver = false;
+
+    while (true) {
         if (!initialized) {
-            LOG_ERROR("Database health check failed: Connection pool not initialized");
-            return false;
+            throw std::runtime_error("Database connection pool not initialized");
         }
 
-        // Step 1: Get a connection (with locking to ensure thread safety)
-        {
-            std::lock_guard<std::mutex> lock(mutex);
+        // Register as a waiter before the final scan so a concurrent release cannot be missed
+        waiters.fetch_add(1);
+        bool admitted = underLimit();
 
-            // Find an available connection or create a new one
-            for (auto& c : connections) {
-                if (!c->inUse) {
-                    c->inUse = true;
-                    conn = c;
-                    break;
-                }
+        if (admitted) {
+            if (auto conn = tryAcquireIdle(true)) {
+                waiters.fetch_sub(1);
+                return ConnectionLease(this, conn);
             }
+        }
 
-            if (!conn) {
-                // Create a new connection if all are in use
-                auto newConn = createConnection();
-                if (newConn) {
-                    conn = std::make_shared<DBConnection>(newConn);
-                    conn->inUse = true;
-                    connections.push_back(conn);
-                }
+        // Grow the pool if we are still below the hard limit (and the concurrency limit)
+        if (admitted && static_cast<int>(connections.size()) + pendingConnections < std::min(maxPoolSize, currentLimit())) {
+            waiters.fetch_sub(1);
+            ++pendingConnections;
+            lock.unlock();
+
+            std::shared_ptr<sql::Connection> newConn;
+            try {
+                newConn = createConnection();
+            } catch (...) {
+                lock.lock();
+                --pendingConnections;
+                wakeWaiters();
+                throw;
             }
+
+            // The caller was admitted by allowRequest, so its connect counts like any request
+            // (and as the probe when the breaker is half-open)
+            if (newConn) {
+                breaker->recordSuccess();
+            } else {
+                breaker->recordFailure("connect failed");
+            }
+
+            lock.lock();
+            --pendingConnections;
+
+            if (!newConn) {
+                wakeWaiters();
+                LOG_ERROR("Error creating a new database connection");
+                throw std::runtime_error("Failed to create a new database connection");
+            }
+
+            auto conn = std::make_shared<DBConnection>(newConn, statementCacheSize, breaker);
+            connections.push_back(conn);
+
+            LOG_INFO("Created a new database connection. Pool size: " +
+                         std::to_string(connections.size()));
+
+            return ConnectionLease(this, conn);
         }
 
-        if (!conn) {
-            LOG_ERROR("Database health check failed: Unable to get connection");
-            return false;
+        // Pool is exhausted; turn the caller away at once rather than queue it behind a full backlog
+        int limit = maxWaiters.load();
+        if (!handedOver && limit > 0 && static_cast<int>(waitQueue.size()) >= limit) {
+            waiters.fetch_sub(1);
+            shedCount.fetch_add(1);
+            throw PoolSaturatedError(PoolSaturatedError::Reason::QueueFull,
+                                     "Too many requests waiting for a database connection", getRetryAfterSeconds());
         }
 
-        // Step 2: Perform a simple test query
-        try {
-            std::cout << "Health check: Executing test query..." << std::endl;
+        auto now = std::chrono::steady_clock::now();
+        auto waitUntil = deadline;
+        if (queueOverloaded(now)) {
+            waitUntil = std::min(deadline, now + queueTarget);
+        }
+        if (waitQueue.empty()) {
+            queueLastEmpty = now;
+        }
 
-            // Create statement directly instead of using helper method
-            std::unique_ptr<sql::Statement> stmt(conn->getConnection()->createStatement());
-            if (!stmt) {
-                std::cout << "Health check: Failed to create statement" << std::endl;
-                throw std::runtime_error("Failed to create statement");
-            }
+        // A waiter whose connection was taken by a fast-path caller keeps its place in FIFO order
+        if (handedOver && queuePolicy != QueuePolicy::Lifo) {
+            waitQueue.push_front(&waiter);
+        } else {
+            waitQueue.push_back(&waiter);
+        }
+        waiter.signalled = false;
 
-            // Execute query and get result set
-            std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT 1 AS test_value"));
-            if (!res) {
-                std::cout << "Health check: Failed to get result set" << std::endl;
-                throw std::runtime_error("Failed to get result set");
+        recentWaits.fetch_add(1);
+        handedOver = waiter.cv.wait_until(lock, waitUntil, [&waiter] { return waiter.signalled; });
+        waiters.fetch_sub(1);
+
+        if (!handedOver) {
+            waitQueue.erase(std::find(waitQueue.begin(), waitQueue.end(), &waiter));
+            if (waitQueue.empty()) {
+                queueLastEmpty = std::chrono::steady_clock::now();
             }
 
-            // Check the result immediately
-            bool hasRow = res->next();
-            if (!hasRow) {
-                std::cout << "Health check: Result set has no rows" << std::endl;
-                throw std::runtime_error("Result set has no rows");
+            if (underLimit()) {
+                if (auto conn = tryAcquireIdle(true)) {
+                    return ConnectionLease(this, conn);
+                }
             }
 
-            int value = res->getInt("test_value");
-            std::cout << "Health check: Got value: " << value << std::endl;
+            shedCount.fetch_add(1);
+            LOG_WARNING("Timed out waiting for a database connection. Pool size: " +
+                            std::to_string(connections.size()) + ", waiting: " + std::to_string(waitQueue.size()));
+            throw PoolSaturatedError(PoolSaturatedError::Reason::Timeout,
+                                     "Timed out waiting for a database connection", getRetryAfterSeconds());
+        }
+    }
+}
 
-            // Close the result set explicitly
-            res.reset();
+void DBConnectionPool::wakeWaiters(size_t count) {
+    auto now = std::chrono::steady_clock::now();
+    bool newestFirst = queuePolicy == QueuePolicy::Lifo || queueOverloaded(now);
 
-            // Close the statement explicitly
-            stmt.reset();
+    for (; count > 0 && !waitQueue.empty(); --count) {
+        Waiter* waiter;
+        if (newestFirst) {
+            waiter = waitQueue.back();
+            waitQueue.pop_back();
+        } else {
+            waiter = waitQueue.front();
+            waitQueue.pop_front();
+        }
+
+        waiter->signalled = true;
+        waiter->cv.notify_one();
+    }
+
+    if (waitQueue.empty()) {
+        queueLastEmpty = now;
+    }
+}
+
+void DBConnectionPool::wakeAllWaiters() {
+    wakeWaiters(waitQueue.size());
+}
+
+bool DBConnectionPool::queueOverloaded(std::chrono::steady_clock::time_point now) const {
+    // CoDel: a queue that drains now and then is absorbing a burst; one that has stayed
+    // non-empty for a whole interval is a standing backlog
+    return queuePolicy == QueuePolicy::CoDel && !waitQueue.empty() && now - queueLastEmpty > queueInterval;
+}
+
+int DBConnectionPool::getRetryAfterSeconds() const {
+    // A retry is only useful once the current backlog had time to clear
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(acquireTimeout).count();
+    return static_cast<int>(std::max<long long>(1, seconds));
+}
+
+void DBConnectionPool::setQueuePolicy(const std::string& policy) {
+    if (policy == "fifo") {
+        queuePolicy = QueuePolicy::Fifo;
+    } else if (policy == "lifo") {
+        queuePolicy = QueuePolicy::Lifo;
+    } else {
+        if (policy != "codel") {
+            LOG_WARNING("Unknown database queue policy '" + policy + "', using codel");
+        }
+        queuePolicy = QueuePolicy::CoDel;
+    }
+}
 
-            // Mark connection as not in use
-            {
-                std::lock_guard<std::mutex> lock(mutex);
-                conn->inUse = false;
+int DBConnectionPool::currentLimit() const {
+    return adaptiveLimit ? limiter.getLimit() : maxPoolSize;
+}
+
+void DBConnectionPool::recordLeaseTime(std::chrono::steady_clock::time_point acquiredAt, int inflight) {
+    if (!adaptiveLimit) {
+        return;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - acquiredAt);
+    limiter.onSample(elapsed, inflight);
+}
+
+bool DBConnectionPool::isSaturated() const {
+    auto full = [](const DBConnectionPool& pool) {
+        int limit = pool.maxWaiters.load();
+        return limit > 0 && pool.waiters.load() >= limit;
+    };
+
+    if (!full(*this)) {
+        return false;
+    }
+
+    for (const auto& replica : replicas) {
+        if (!full(*replica)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DBConnectionPool::releaseConnection(const std::shared_ptr<DBConnection>& conn) {
+    // Connections returned after cleanup() are simply dropped
+    if (!initialized) {
+        return;
+    }
+
+    if (!resetSession(conn)) {
+        return;
+    }
+
+    conn->lastUsed = std::chrono::steady_clock::now();
+    pushIdle(conn);
+
+    // Only take the pool-wide mutex when somebody is actually blocked on it
+    if (waiters.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeWaiters();
+    }
+}
+
+bool DBConnectionPool::resetSession(const std::shared_ptr<DBConnection>& conn) {
+    // A connection left in manual-commit mode would hand its open transaction
+    // and locks to the next caller; roll it back, or drop it if that fails.
+    // One whose Transaction could not be rolled back or committed is dropped outright.
+    std::string error = "transaction could not be ended";
+    try {
+        if (!conn->transactionFailed()) {
+            if (!conn->getConnection()->getAutoCommit()) {
+                LOG_WARNING("Connection returned to the pool inside a transaction; rolling back");
+                conn->getConnection()->rollback();
+                conn->getConnection()->setAutoCommit(true);
             }
+            return true;
+        }
+    }
+    catch (const sql::SQLException& e) {
+        error = e.what();
+    }
+
+    LOG_ERROR("Discarding connection that could not be reset: " + error);
+    retireConnection(conn, false);
+    if (waiters.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeWaiters();
+    }
+    return false;
+}
+
+void DBConnectionPool::startMaintenance() {
+    {
+        std::lock_guard<std::mutex> lock(maintenanceMutex);
+        stopMaintenance = false;
+    }
+    maintenanceThread = std::thread(&DBConnectionPool::maintenanceLoop, this);
+}
+
+void DBConnectionPool::stopMaintenanceThread() {
+    {
+        std::lock_guard<std::mutex> lock(maintenanceMutex);
+        stopMaintenance = true;
+    }
+    maintenanceCv.notify_all();
+
+    if (maintenanceThread.joinable() && maintenanceThread.get_id() != std::this_thread::get_id()) {
+        maintenanceThread.join();
+    }
+}
 
-            return (value == 1);
+void DBConnectionPool::maintenanceLoop() {
+    std::unique_lock<std::mutex> lock(maintenanceMutex);
+
+    while (!maintenanceCv.wait_for(lock, maintenanceInterval, [this] { return stopMaintenance; })) {
+        lock.unlock();
+        try {
+            runMaintenance();
+        }
+        catch (const std::exception& e) {
+            LOG_ERROR("Error in database pool maintenance: " + std::string(e.what()));
+        }
+        lock.lock();
+    }
+}
 
-        } catch (const sql::SQLException& e) {
-            std::cout << "Health check: SQL exception: " << e.what() << std::endl;
-            LOG_ERROR("Database health check SQL error: " + std::string(e.what()));
+void DBConnectionPool::runMaintenance() {
+    auto now = std::chrono::steady_clock::now();
 
-            // Make sure to release the connection even if there's an error
-            {
-                std::lock_guard<std::mutex> lock(mutex);
-                if (conn) conn->inUse = false;
+    // Connections parked on threads that have gone quiet go back to the shared free-lists
+    reclaimAffine(now);
+
+    // Pull out idle connections that are due for a ping or have been idle long enough to close.
+    // Recently used connections stay in their shard untouched.
+    auto checkAfter = std::min(keepaliveInterval, idleTimeout);
+    std::vector<std::shared_ptr<DBConnection>> due;
+
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> shardLock(shard->mutex);
+        auto split = std::partition(shard->idle.begin(), shard->idle.end(), [&](const auto& conn) {
+            return now - std::max(conn->lastUsed, conn->lastChecked) < checkAfter;
+        });
+        due.insert(due.end(), std::make_move_iterator(split), std::make_move_iterator(shard->idle.end()));
+        shard->idle.erase(split, shard->idle.end());
+    }
+
+    int evicted = 0;
+    int broken = 0;
+
+    // Connections the concurrency limit no longer lets out are closed at their next check
+    int excess = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        excess = static_cast<int>(connections.size()) - currentLimit();
+    }
+
+    for (auto& conn : due) {
+        // Shrink back towards the minimum after an idle period
+        if ((now - conn->lastUsed >= idleTimeout || excess > 0) && retireConnection(conn, true)) {
+            ++evicted;
+            --excess;
+            continue;
+        }
+
+        // Keepalive pings also tell a closed circuit breaker about an outage when there is no
+        // traffic; once it has opened only its half-open probe may move it
+        bool reporting = breaker->isClosed();
+        if (!conn->ping()) {
+            if (reporting) {
+                breaker->recordFailure("keepalive ping failed");
             }
+            retireConnection(conn, false);
+            ++broken;
+            continue;
+        }
+        if (reporting) {
+            breaker->recordSuccess();
+        }
 
-            return false;
+        conn->lastChecked = now;
+        pushIdle(conn);
+    }
+
+    // Each connection checked is either back in a shard or has freed a slot to grow into
+    if (!due.empty() && waiters.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeWaiters(due.size());
+    }
+
+    // Work out how many connections to open: refill up to the minimum, and grow ahead of demand
+    // by the number of callers that had to wait since the last run
+    int waited = recentWaits.exchange(0);
+    int toOpen = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int total = static_cast<int>(connections.size()) + pendingConnections;
+        int target = std::max(minPoolSize, total + waited);
+        toOpen = std::max(0, std::min(target, std::min(maxPoolSize, currentLimit())) - total);
+    }
+
+    // While the breaker is open, leave reconnecting to its probe
+    int opened = 0;
+    for (int i = 0; i < toOpen && initialized && breaker->isClosed(); ++i) {
+        if (!addIdleConnection()) {
+            break;
         }
+        ++opened;
     }
-    catch (const std::exception& e) {
-        std::cout << "Health check: General exception: " << e.what() << std::endl;
-        LOG_ERROR("Database health check failed: " + std::string(e.what()));
 
-        // Make sure to release the connection even if there's an error
-        if (conn) {
-            std::lock_guard<std::mutex> lock(mutex);
-            conn->inUse = false;
+    if (evicted > 0 || broken > 0 || opened > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        LOG_INFO("Database pool maintenance: closed " + std::to_string(evicted) + " idle, replaced " +
+                     std::to_string(broken) + " broken, opened " + std::to_string(opened) +
+                     ". Pool size: " + std::to_string(connections.size()));
+    }
+}
+
+bool DBConnectionPool::addIdleConnection() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (static_cast<int>(connections.size()) + pendingConnections >= maxPoolSize) {
+            return false;
         }
+        ++pendingConnections;
+    }
+
+    // Maintenance only opens connections while the breaker is closed; it must not close one
+    bool reporting = breaker->isClosed();
 
+    std::shared_ptr<sql::Connection> newConn;
+    try {
+        newConn = createConnection();
+    } catch (...) {
+        newConn = nullptr;
+    }
+
+    if (reporting && newConn) {
+        breaker->recordSuccess();
+    } else if (reporting) {
+        breaker->recordFailure("maintenance connect failed");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    --pendingConnections;
+
+    if (!newConn || !initialized) {
         return false;
     }
+
+    auto conn = std::make_shared<DBConnection>(newConn, statementCacheSize, breaker);
+    connections.push_back(conn);
+    pushIdle(conn);
+    wakeWaiters();
+
+    return true;
+}
+
+bool DBConnectionPool::retireConnection(const std::shared_ptr<DBConnection>& conn, bool keepMinimum) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (keepMinimum && static_cast<int>(connections.size()) <= minPoolSize) {
+        return false;
+    }
+
+    connections.erase(std::remove(connections.begin(), connections.end(), conn), connections.end());
+    return true;
+}
+
+bool DBConnectionPool::checkHealth() {
+    if (!initialized) {
+        return false;
+    }
+
+    HealthStatus status = getHealthStatus();
+    return status.healthy && !status.stale;
+}
+
+DBConnectionPool::HealthStatus DBConnectionPool::getHealthStatus() {
+    std::lock_guard<std::mutex> lock(healthMutex);
+
+    HealthStatus status = healthStatus;
+    if (lastProbe != std::chrono::steady_clock::time_point()) {
+        status.ageMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - lastProbe).count();
+        status.stale = status.ageMs > 3 * healthProbeInterval.count();
+    }
+    return status;
+}
+
+DBConnectionPool::PoolStats DBConnectionPool::getStats() {
+    PoolStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.size = static_cast<int>(connections.size());
+        stats.pending = pendingConnections;
+    }
+
+    stats.maxSize = maxPoolSize;
+    stats.leased = leasedConnections.load();
+    stats.idle = std::max(0, stats.size - stats.leased);
+    stats.waiters = waiters.load();
+    stats.shed = shedCount.load();
+    stats.limit = currentLimit();
+    return stats;
+}
+
+void DBConnectionPool::startHealthProbe() {
+    {
+        std::lock_guard<std::mutex> lock(healthMutex);
+        stopHealthProbe = false;
+    }
+    healthThread = std::thread(&DBConnectionPool::healthProbeLoop, this);
+}
+
+void DBConnectionPool::stopHealthProbeThread() {
+    {
+        std::lock_guard<std::mutex> lock(healthMutex);
+        stopHealthProbe = true;
+    }
+    healthCv.notify_all();
+
+    if (healthThread.joinable() && healthThread.get_id() != std::this_thread::get_id()) {
+        healthThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(healthMutex);
+    healthStatus = HealthStatus();
+    lastProbe = std::chrono::steady_clock::time_point();
+}
+
+void DBConnectionPool::healthProbeLoop() {
+    // Owned by this thread only; never counted in, or handed out by, the pool
+    std::shared_ptr<sql::Connection> probeConnection;
+
+    std::unique_lock<std::mutex> lock(healthMutex);
+    do {
+        lock.unlock();
+        runHealthProbe(probeConnection);
+        lock.lock();
+    } while (!healthCv.wait_for(lock, healthProbeInterval, [this] { return stopHealthProbe; }));
+    lock.unlock();
+
+    if (probeConnection) {
+        try {
+            probeConnection->close();
+        }
+        catch (const sql::SQLException& e) {
+            LOG_WARNING("Error closing health probe connection: " + std::string(e.what()));
+        }
+    }
+}
+
+void DBConnectionPool::runHealthProbe(std::shared_ptr<sql::Connection>& probeConnection) {
+    auto started = std::chrono::steady_clock::now();
+    std::string error;
+
+    // While the breaker is open the probe still tracks health, but only reports to the breaker
+    // once it is let through as the half-open probe
+    bool reporting = breaker->allowProbe();
+
+    try {
+        if (!probeConnection) {
+            probeConnection = createConnection();
+        }
+
+        if (!probeConnection) {
+            error = "Could not open health probe connection";
+        } else {
+            std::unique_ptr<sql::Statement> stmt(probeConnection->createStatement());
+            std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT 1"));
+            if (!res || !res->next() || res->getInt(1) != 1) {
+                error = "Unexpected result from health probe query";
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    auto finished = std::chrono::steady_clock::now();
+
+    // The probe feeds the circuit breaker too, so it notices an idle outage and closes once the
+    // database is back; a failed connect counts the same as a failed query
+    if (reporting && error.empty()) {
+        breaker->recordSuccess();
+    } else if (reporting) {
+        breaker->recordFailure(error);
+    }
+
+    // Reconnect from scratch next time rather than trusting a connection that just failed
+    if (!error.empty()) {
+        probeConnection.reset();
+    }
+
+    std::lock_guard<std::mutex> lock(healthMutex);
+    bool wasHealthy = healthStatus.healthy;
+
+    lastProbe = finished;
+    healthStatus.healthy = error.empty();
+    healthStatus.lastError = error;
+
+    if (error.empty()) {
+        healthStatus.latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(finished - started).count();
+        healthStatus.consecutiveFailures = 0;
+        if (!wasHealthy) {
+            LOG_INFO("Database health probe succeeded for " + host + ":" + std::to_string(port));
+        }
+    } else {
+        // Only log state changes so a database outage does not flood the log once per second
+        if (healthStatus.consecutiveFailures++ == 0) {
+            LOG_ERROR("Database health probe failed for " + host + ":" + std::to_string(port) + ": " + error);
+        }
+    }
 }
 
 std::shared_ptr<sql::Connection> DBConnectionPool::createConnection() {
     try {
-        // Build connection properties
         // Build connection properties
         sql::SQLString url("jdbc:mariadb://" + host + ":" + std::to_string(port) + "/" + database);
         sql::Properties properties({
@@ -304,12 +1580,14 @@ std::shared_ptr<sql::Connection> DBConnectionPool::createConnection() {
             {"autoReconnect", "true"},
             {"useUnicode", "true"},
             {"characterEncoding", "utf8mb4"},
+            {"useServerPrepStmts", "true"},  // prepared once per connection and reused from the statement cache
+            {"allowMultiQueries", "true"},   // needed by DBConnection::executeBatch
             {"connectTimeout", "5000"},  // 5 second timeout
             {"socketTimeout", "5000"},   // 5 second timeout
             {"loginTimeout", "5000"}     // 5 second timeout
         });
 
-        std::cout << "Attempting to connect to DB with URL: " << url.c_str() << std::endl;
+        LOG_DEBUG("Attempting to connect to DB with URL: " + std::string(url.c_str()));
 
         // Create connection
         sql::Connection* rawConn = driver->connect(url, properties);
@@ -323,14 +1601,33 @@ std::shared_ptr<sql::Connection> DBConnectionPool::createConnection() {
     }
 }
 
+void DBConnectionPool::cleanup() {
+    // Replica pools stay allocated: outstanding leases still point at them
+    for (auto& replica : replicas) {
+        replica->cleanup();
+    }
 
+    stopMaintenanceThread();
+    stopHealthProbeThread();
+    releaseAffineSlots();
 
-void DBConnectionPool::cleanup() {
-    std::lock_guard<std::mutex> lock(mutex);
+    // Let any warm-up connections still in flight finish before tearing the pool down
+    joinWarmupThreads();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
 
-    // Clear all connections
-    connections.clear();
-    initialized = false;
+        // Clear all connections; outstanding leases keep theirs alive until released
+        initialized = false;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            shard->idle.clear();
+        }
+        connections.clear();
+
+        // Wake any waiters so they fail fast instead of sitting out their timeout
+        wakeAllWaiters();
+    }
 
     LOG_INFO("Database connection pool cleaned up");
 }
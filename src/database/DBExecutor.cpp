@@ -0,0 +1,98 @@
+#include "../../include/database/DBExecutor.h"
+#include "../../include/utils/Logger.h"
+#include <stdexcept>
+#include <algorithm>
+
+DBExecutor::~DBExecutor() {
+    stop();
+}
+
+void DBExecutor::start(int threads, int maxQueued) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (running) {
+        LOG_WARNING("Database executor already started");
+        return;
+    }
+
+    if (threads <= 0) {
+        LOG_INFO("Database executor disabled; queries run on the request threads");
+        return;
+    }
+
+    this->maxQueued = static_cast<size_t>(std::max(1, maxQueued));
+    running = true;
+
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&DBExecutor::workerLoop, this);
+    }
+
+    LOG_INFO("Database executor started with " + std::to_string(threads) +
+             " threads and a queue of " + std::to_string(this->maxQueued));
+}
+
+void DBExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+
+    jobAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+
+    LOG_INFO("Database executor stopped");
+}
+
+bool DBExecutor::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!running) {
+            return false;
+        }
+
+        if (jobs.size() >= maxQueued) {
+            throw PoolSaturatedError(PoolSaturatedError::Reason::QueueFull, "Database executor queue is full");
+        }
+
+        jobs.push_back(std::move(job));
+        queued++;
+    }
+
+    jobAvailable.notify_one();
+    return true;
+}
+
+void DBExecutor::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return !running || !jobs.empty(); });
+
+            // Drain what is already queued before exiting so no future is left unresolved
+            if (jobs.empty()) {
+                return;
+            }
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            queued--;
+        }
+
+        active++;
+        // packaged_task stores any exception in the future, so job() does not throw
+        job();
+        active--;
+    }
+}
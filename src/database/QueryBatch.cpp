@@ -0,0 +1,151 @@
+#include "../../include/database/QueryBatch.h"
+#include "../../include/utils/Logger.h"
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+// SqlLiteral implementation
+std::string SqlLiteral::of(long long value) {
+    return std::to_string(value);
+}
+
+std::string SqlLiteral::of(double value) {
+    std::ostringstream ss;
+    ss << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+    return ss.str();
+}
+
+std::string SqlLiteral::of(const std::string& value) {
+    // The introducer keeps it a character string, so the column's collation still applies
+    static const char* hexDigits = "0123456789ABCDEF";
+
+    if (value.empty()) {
+        return "''";
+    }
+
+    std::string literal = "_utf8mb4 X'";
+    literal.reserve(literal.size() + value.size() * 2 + 1);
+    for (unsigned char c : value) {
+        literal += hexDigits[c >> 4];
+        literal += hexDigits[c & 0x0F];
+    }
+    literal += "'";
+
+    return literal;
+}
+
+// QueryBatch implementation
+QueryBatch& QueryBatch::add(const std::string& query) {
+    statements.push_back({query, {}});
+    return *this;
+}
+
+QueryBatch& QueryBatch::bind(int value) {
+    return bindLiteral(SqlLiteral::of(static_cast<long long>(value)));
+}
+
+QueryBatch& QueryBatch::bind(long long value) {
+    return bindLiteral(SqlLiteral::of(value));
+}
+
+QueryBatch& QueryBatch::bind(double value) {
+    return bindLiteral(SqlLiteral::of(value));
+}
+
+QueryBatch& QueryBatch::bind(const std::string& value) {
+    return bindLiteral(SqlLiteral::of(value));
+}
+
+QueryBatch& QueryBatch::bindNull() {
+    return bindLiteral("NULL");
+}
+
+QueryBatch& QueryBatch::bindLiteral(std::string literal) {
+    if (statements.empty()) {
+        throw std::invalid_argument("QueryBatch: bind called before add");
+    }
+    statements.back().literals.push_back(std::move(literal));
+    return *this;
+}
+
+std::string QueryBatch::render() const {
+    std::string sql;
+
+    for (const auto& statement : statements) {
+        size_t bound = 0;
+        char quote = 0;
+
+        for (char c : statement.query) {
+            // Placeholders inside quoted text are left alone
+            if (quote) {
+                if (c == quote) {
+                    quote = 0;
+                }
+                sql += c;
+            } else if (c == '\'' || c == '"' || c == '`') {
+                quote = c;
+                sql += c;
+            } else if (c == '?') {
+                if (bound >= statement.literals.size()) {
+                    throw std::invalid_argument("QueryBatch: not enough values bound for: " + statement.query);
+                }
+                sql += statement.literals[bound++];
+            } else {
+                sql += c;
+            }
+        }
+
+        if (bound != statement.literals.size()) {
+            throw std::invalid_argument("QueryBatch: too many values bound for: " + statement.query);
+        }
+
+        sql += ";\n";
+    }
+
+    return sql;
+}
+
+// BatchResult implementation
+BatchResult::BatchResult(std::unique_ptr<sql::Statement> statement, bool hasResultSet)
+    : statement(std::move(statement)), pending(hasResultSet) {}
+
+BatchResult::~BatchResult() {
+    if (!statement) {
+        return;
+    }
+
+    try {
+        // Moving to the next result discards the current one
+        current.reset();
+        while (advance()) {
+        }
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("Error draining batch results: " + std::string(e.what()));
+    }
+}
+
+sql::ResultSet* BatchResult::next() {
+    current.reset();
+
+    if (!pending && !advance()) {
+        throw std::runtime_error("Query batch has no more result sets");
+    }
+
+    pending = false;
+    current.reset(statement->getResultSet());
+    return current.get();
+}
+
+bool BatchResult::advance() {
+    while (true) {
+        if (statement->getMoreResults()) {
+            return true;
+        }
+        // No result set and no update count means the batch is exhausted
+        if (statement->getUpdateCount() == -1) {
+            return false;
+        }
+    }
+}
@@ -0,0 +1,245 @@
+#include "../../include/database/QueryCache.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+QueryCache::Lookup QueryCache::lookup(const std::string& key, const std::vector<std::string>& tables) {
+    Lookup result;
+    if (maxBytes.load(std::memory_order_relaxed) == 0) {
+        return result;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto& shard = shardFor(key);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            auto entry = it->second;
+
+            if (now < entry->expires && currentVersions(entry->tables) == entry->versions) {
+                shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+                hits.fetch_add(1, std::memory_order_relaxed);
+                result.value = entry->value;
+                return result;
+            }
+
+            stale.fetch_add(1, std::memory_order_relaxed);
+            erase(shard, entry);
+        }
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+
+    result.enabled = true;
+    result.key = key;
+    result.tables = tables;
+    result.versions = currentVersions(tables);
+    return result;
+}
+
+void QueryCache::store(const Lookup& miss, std::string value) {
+    size_t limit = maxBytes.load(std::memory_order_relaxed);
+    if (!miss.enabled || limit == 0) {
+        return;
+    }
+
+    // A write landed while the query ran; the value may not include it
+    if (currentVersions(miss.tables) != miss.versions) {
+        return;
+    }
+
+    size_t bytes = miss.key.size() * 2 + value.size() + sizeof(Entry);
+    size_t shardLimit = limit / kShards;
+    if (bytes > shardLimit) {
+        return;
+    }
+
+    auto& shard = shardFor(miss.key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto existing = shard.index.find(miss.key);
+    if (existing != shard.index.end()) {
+        erase(shard, existing->second);
+    }
+
+    shard.entries.push_front({
+        miss.key,
+        std::make_shared<const std::string>(std::move(value)),
+        miss.tables,
+        miss.versions,
+        std::chrono::steady_clock::now() + ttl,
+        bytes
+    });
+    shard.index[miss.key] = shard.entries.begin();
+    shard.bytes += bytes;
+
+    // Evict least recently used entries until the shard is back within its share
+    while (shard.bytes > shardLimit && shard.entries.size() > 1) {
+        erase(shard, std::prev(shard.entries.end()));
+        evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void QueryCache::invalidate(const std::vector<std::string>& tables) {
+    if (tables.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(versionsMutex);
+    for (const auto& table : tables) {
+        versions[table]++;
+    }
+    invalidations.fetch_add(tables.size(), std::memory_order_relaxed);
+}
+
+std::vector<std::string> QueryCache::tablesWritten(const std::string& sql) {
+    // Tokenize into lower-cased words, skipping quoted text; backticked names are kept as words
+    std::vector<std::string> words;
+    std::string word;
+    char quote = 0;
+
+    auto flush = [&] {
+        if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    };
+
+    for (size_t i = 0; i < sql.size(); ++i) {
+        char c = sql[i];
+
+        if (quote) {
+            if (c == '\\' && quote != '`') {
+                ++i;
+            } else if (c == quote) {
+                quote = 0;
+                if (c == '`') {
+                    flush();
+                }
+            } else if (quote == '`') {
+                word += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            continue;
+        }
+
+        if (c == '\'' || c == '"' || c == '`') {
+            flush();
+            quote = c;
+        } else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$') {
+            word += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else if (c == '.') {
+            // Drop the schema in schema.table (or `schema`.`table`)
+            if (!word.empty()) {
+                word.clear();
+            } else if (i > 0 && sql[i - 1] == '`' && !words.empty()) {
+                words.pop_back();
+            }
+        } else {
+            flush();
+            if (c == ';') {
+                words.push_back(";");
+            }
+        }
+    }
+    flush();
+
+    static const std::vector<std::string> writeVerbs = {
+        "insert", "replace", "update", "delete", "truncate", "alter", "drop", "create", "rename", "load"
+    };
+    static const std::vector<std::string> tableKeywords = {"into", "update", "from", "join", "table"};
+    static const std::vector<std::string> modifiers = {
+        "low_priority", "delayed", "high_priority", "quick", "ignore", "temporary", "if", "not", "exists"
+    };
+
+    auto contains = [](const std::vector<std::string>& list, const std::string& value) {
+        return std::find(list.begin(), list.end(), value) != list.end();
+    };
+
+    // Every name after INTO/UPDATE/FROM/JOIN/TABLE in a write statement; reading tables such as
+    // a subquery's FROM are included too, which only means some extra invalidation
+    std::vector<std::string> tables;
+    bool statementStart = true;
+    bool writing = false;
+
+    for (size_t i = 0; i < words.size(); ++i) {
+        const std::string& current = words[i];
+
+        if (current == ";") {
+            statementStart = true;
+            writing = false;
+            continue;
+        }
+
+        if (statementStart) {
+            writing = contains(writeVerbs, current);
+            statementStart = false;
+        }
+
+        if (!writing || !contains(tableKeywords, current)) {
+            continue;
+        }
+
+        size_t next = i + 1;
+        while (next < words.size() && contains(modifiers, words[next])) {
+            ++next;
+        }
+        if (next < words.size() && words[next] != ";" && words[next] != "select" &&
+            !contains(tables, words[next])) {
+            tables.push_back(words[next]);
+        }
+    }
+
+    return tables;
+}
+
+QueryCache::Stats QueryCache::getStats() {
+    Stats stats{};
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    stats.stale = stale.load(std::memory_order_relaxed);
+    stats.evictions = evictions.load(std::memory_order_relaxed);
+    stats.invalidations = invalidations.load(std::memory_order_relaxed);
+    stats.maxBytes = maxBytes.load(std::memory_order_relaxed);
+
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.entries += shard.entries.size();
+        stats.bytes += shard.bytes;
+    }
+
+    return stats;
+}
+
+void QueryCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+        shard.bytes = 0;
+    }
+}
+
+QueryCache::Shard& QueryCache::shardFor(const std::string& key) {
+    return shards[std::hash<std::string>{}(key) % kShards];
+}
+
+std::vector<uint64_t> QueryCache::currentVersions(const std::vector<std::string>& tables) {
+    std::vector<uint64_t> current;
+    current.reserve(tables.size());
+
+    std::shared_lock<std::shared_mutex> lock(versionsMutex);
+    for (const auto& table : tables) {
+        auto it = versions.find(table);
+        current.push_back(it != versions.end() ? it->second : 0);
+    }
+    return current;
+}
+
+void QueryCache::erase(Shard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->bytes;
+    shard.index.erase(it->key);
+    shard.entries.erase(it);
+}
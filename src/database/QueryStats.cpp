@@ -0,0 +1,257 @@
+#include "../../include/database/QueryStats.h"
+#include "../../include/utils/Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+std::string QueryStats::fingerprint(const std::string& query) {
+    std::string out;
+    out.reserve(query.size());
+
+    size_t i = 0;
+    while (i < query.size()) {
+        char c = query[i];
+
+        // Quoted strings become a placeholder
+        if (c == '\'' || c == '"') {
+            char quote = c;
+            ++i;
+            while (i < query.size()) {
+                if (query[i] == '\\') {
+                    i += 2;
+                    continue;
+                }
+                if (query[i] == quote) {
+                    // A doubled quote is an escaped quote inside the literal
+                    if (i + 1 < query.size() && query[i + 1] == quote) {
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++i;
+            }
+            ++i;
+            out += '?';
+            continue;
+        }
+
+        // Hex literals (X'..' is handled above once the prefix is dropped)
+        if ((c == 'X' || c == 'x') && i + 1 < query.size() && query[i + 1] == '\'' &&
+            (out.empty() || !std::isalnum(static_cast<unsigned char>(out.back())))) {
+            ++i;
+            continue;
+        }
+
+        // Numbers that are not part of an identifier become a placeholder
+        if (std::isdigit(static_cast<unsigned char>(c)) &&
+            (out.empty() || !(std::isalnum(static_cast<unsigned char>(out.back())) || out.back() == '_'))) {
+            while (i < query.size() && (std::isalnum(static_cast<unsigned char>(query[i])) || query[i] == '.')) {
+                ++i;
+            }
+            out += '?';
+            continue;
+        }
+
+        // Collapse runs of whitespace into one space
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            while (i < query.size() && std::isspace(static_cast<unsigned char>(query[i]))) {
+                ++i;
+            }
+            if (!out.empty() && out.back() != ' ' && out.back() != '(') {
+                out += ' ';
+            }
+            continue;
+        }
+
+        if (c == ')' && !out.empty() && out.back() == ' ') {
+            out.pop_back();
+        }
+
+        out += c;
+        ++i;
+    }
+
+    while (!out.empty() && (out.back() == ' ' || out.back() == ';')) {
+        out.pop_back();
+    }
+
+    // Fold placeholder lists: (?, ?, ?) -> (?+), and repeated rows (?+), (?+) -> (?+)
+    const std::string group = "(?+)";
+    std::string folded;
+    folded.reserve(out.size());
+
+    for (size_t pos = 0; pos < out.size();) {
+        if (out[pos] == '(') {
+            size_t end = out.find(')', pos);
+            if (end != std::string::npos && end > pos + 1 &&
+                out.find_first_not_of("?, ", pos + 1) >= end) {
+                bool previousRow = folded.size() >= group.size() + 2 &&
+                                   folded.compare(folded.size() - group.size() - 2, std::string::npos, group + ", ") == 0;
+                if (previousRow) {
+                    folded.resize(folded.size() - 2);
+                } else {
+                    folded += group;
+                }
+                pos = end + 1;
+                continue;
+            }
+        }
+        folded += out[pos++];
+    }
+
+    return folded;
+}
+
+int QueryStats::countParameters(const std::string& query) {
+    int count = 0;
+    char quote = 0;
+
+    for (char c : query) {
+        if (quote) {
+            if (c == quote) {
+                quote = 0;
+            }
+        } else if (c == '\'' || c == '"' || c == '`') {
+            quote = c;
+        } else if (c == '?') {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+QueryStats::Entry* QueryStats::entryFor(const std::string& query) {
+    std::string key = fingerprint(query);
+
+    // Plain SQL looks its entry up on every execution, so the common case of a known
+    // fingerprint only takes the lock shared
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            return it->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        return it->second.get();
+    }
+
+    if (entries.size() >= kMaxFingerprints) {
+        key = "(other statements)";
+        it = entries.find(key);
+        if (it != entries.end()) {
+            return it->second.get();
+        }
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->fingerprint = key;
+    Entry* raw = entry.get();
+    entries.emplace(key, std::move(entry));
+    return raw;
+}
+
+void QueryStats::record(Entry* entry, std::chrono::microseconds elapsed, uint64_t rows, int parameterCount) {
+    uint64_t us = static_cast<uint64_t>(std::max<int64_t>(0, elapsed.count()));
+
+    entry->count.fetch_add(1, std::memory_order_relaxed);
+    entry->totalUs.fetch_add(us, std::memory_order_relaxed);
+    entry->rows.fetch_add(rows, std::memory_order_relaxed);
+    entry->histogram[bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t previousMax = entry->maxUs.load(std::memory_order_relaxed);
+    while (us > previousMax && !entry->maxUs.compare_exchange_weak(previousMax, us, std::memory_order_relaxed)) {
+    }
+
+    int64_t threshold = slowQueryThresholdUs.load(std::memory_order_relaxed);
+    if (threshold > 0 && static_cast<int64_t>(us) >= threshold) {
+        entry->slow.fetch_add(1, std::memory_order_relaxed);
+        LOG_WARNING("Slow query: " + std::to_string(us / 1000) + " ms, " +
+                    std::to_string(parameterCount) + " bound parameters, " +
+                    std::to_string(rows) + " rows: " + entry->fingerprint);
+    }
+}
+
+std::vector<QueryStats::Summary> QueryStats::snapshot() {
+    std::vector<Summary> table;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        table.reserve(entries.size());
+
+        for (const auto& [key, entry] : entries) {
+            uint64_t count = entry->count.load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+
+            table.push_back({
+                entry->fingerprint,
+                count,
+                entry->totalUs.load(std::memory_order_relaxed),
+                percentile(*entry, count, 0.50),
+                percentile(*entry, count, 0.99),
+                entry->maxUs.load(std::memory_order_relaxed),
+                entry->rows.load(std::memory_order_relaxed),
+                entry->slow.load(std::memory_order_relaxed)
+            });
+        }
+    }
+
+    std::sort(table.begin(), table.end(), [](const Summary& a, const Summary& b) {
+        return a.totalUs > b.totalUs;
+    });
+
+    return table;
+}
+
+void QueryStats::reset() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    for (auto& [key, entry] : entries) {
+        entry->count = 0;
+        entry->totalUs = 0;
+        entry->maxUs = 0;
+        entry->rows = 0;
+        entry->slow = 0;
+        for (auto& bucket : entry->histogram) {
+            bucket = 0;
+        }
+    }
+}
+
+size_t QueryStats::bucketFor(uint64_t us) {
+    if (us == 0) {
+        return 0;
+    }
+    size_t bucket = static_cast<size_t>(std::log2(static_cast<double>(us)) * 4.0) + 1;
+    return std::min(bucket, kHistogramBuckets - 1);
+}
+
+uint64_t QueryStats::bucketUpperBound(size_t bucket) {
+    if (bucket == 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(std::ceil(std::exp2(static_cast<double>(bucket) / 4.0)));
+}
+
+uint64_t QueryStats::percentile(const Entry& entry, uint64_t count, double fraction) {
+    uint64_t target = static_cast<uint64_t>(std::ceil(static_cast<double>(count) * fraction));
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < kHistogramBuckets; ++bucket) {
+        seen += entry.histogram[bucket].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            // Never report more than the slowest execution actually seen
+            return std::min(bucketUpperBound(bucket), entry.maxUs.load(std::memory_order_relaxed));
+        }
+    }
+
+    return entry.maxUs.load(std::memory_order_relaxed);
+}
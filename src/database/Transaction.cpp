@@ -0,0 +1,145 @@
+#include "../../include/database/Transaction.h"
+#include "../../include/utils/Logger.h"
+#include <stdexcept>
+
+namespace {
+    const char* isolationName(IsolationLevel isolation) {
+        switch (isolation) {
+            case IsolationLevel::ReadUncommitted: return "READ UNCOMMITTED";
+            case IsolationLevel::ReadCommitted: return "READ COMMITTED";
+            case IsolationLevel::RepeatableRead: return "REPEATABLE READ";
+            case IsolationLevel::Serializable: return "SERIALIZABLE";
+            default: return nullptr;
+        }
+    }
+}
+
+// Transaction implementation
+Transaction::Transaction(std::shared_ptr<sql::Connection> connection, IsolationLevel isolation)
+    : connection(std::move(connection)), active(false), savepointCount(0) {
+    // Without SESSION this only applies to the next transaction, so there is nothing to reset afterwards
+    if (const char* level = isolationName(isolation)) {
+        execute(std::string("SET TRANSACTION ISOLATION LEVEL ") + level);
+    }
+
+    execute("START TRANSACTION");
+    active = true;
+}
+
+Transaction::Transaction(Transaction&& other) noexcept
+    : connection(std::move(other.connection)), onEnd(std::move(other.onEnd)), active(other.active),
+      savepointCount(other.savepointCount) {
+    other.active = false;
+}
+
+Transaction::~Transaction() {
+    if (!active) {
+        return;
+    }
+
+    try {
+        rollback();
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("Error rolling back transaction: " + std::string(e.what()));
+    }
+}
+
+void Transaction::commit() {
+    if (!active) {
+        throw std::logic_error("Transaction is no longer active");
+    }
+
+    // The server ends the transaction even when COMMIT fails
+    finish("COMMIT");
+}
+
+void Transaction::rollback() {
+    if (!active) {
+        return;
+    }
+
+    finish("ROLLBACK");
+}
+
+Transaction::Savepoint Transaction::savepoint() {
+    if (!active) {
+        throw std::logic_error("Transaction is no longer active");
+    }
+
+    std::string name = "sp_" + std::to_string(++savepointCount);
+    execute("SAVEPOINT " + name);
+    return Savepoint(this, name);
+}
+
+void Transaction::execute(const std::string& sql) {
+    try {
+        std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+        stmt->execute(sql);
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("SQL Error in transaction: " + std::string(e.what()) + ". Query: " + sql);
+        throw;
+    }
+}
+
+void Transaction::finish(const std::string& sql) {
+    active = false;
+    auto callback = std::move(onEnd);
+    onEnd = nullptr;
+
+    try {
+        execute(sql);
+    }
+    catch (const sql::SQLException&) {
+        if (callback) {
+            callback(false);
+        }
+        throw;
+    }
+
+    if (callback) {
+        callback(true);
+    }
+}
+
+// Savepoint implementation
+Transaction::Savepoint::Savepoint(Transaction* transaction, std::string name)
+    : transaction(transaction), name(std::move(name)) {}
+
+Transaction::Savepoint::Savepoint(Savepoint&& other) noexcept
+    : transaction(other.transaction), name(std::move(other.name)) {
+    other.transaction = nullptr;
+}
+
+Transaction::Savepoint::~Savepoint() {
+    if (!transaction) {
+        return;
+    }
+
+    try {
+        rollback();
+    }
+    catch (const sql::SQLException& e) {
+        LOG_ERROR("Error rolling back to savepoint " + name + ": " + std::string(e.what()));
+    }
+}
+
+void Transaction::Savepoint::release() {
+    Transaction* owner = transaction;
+    transaction = nullptr;
+
+    // Savepoints disappear with the transaction, so there is nothing to do once it has ended
+    if (owner && owner->active) {
+        owner->execute("RELEASE SAVEPOINT " + name);
+    }
+}
+
+void Transaction::Savepoint::rollback() {
+    Transaction* owner = transaction;
+    transaction = nullptr;
+
+    if (owner && owner->active) {
+        owner->execute("ROLLBACK TO SAVEPOINT " + name);
+    }
+}
@@ -1,17 +1,26 @@
 #include <iostream>
 #include <string>
+#include <algorithm>
+#include <thread>
 #include <crow.h>
 #include <crow/middlewares/cors.h>
 #include "../include/config/Config.h"
 #include "../include/database/DBConnectionPool.h"
+#include "../include/database/DBExecutor.h"
+#include "../include/database/QueryStats.h"
+#include "../include/database/QueryCache.h"
 #include "../include/controllers/HealthController.h"
 #include "../include/controllers/AuthController.h"
 #include "../include/middleware/AuthMiddleware.h"
+#include "../include/middleware/LoadShedMiddleware.h"
 #include "../include/controllers/AircraftController.h"
 #include "../include/controllers/CrewMemberController.h"
 #include "../include/controllers/CrewController.h"
 #include "../include/controllers/FlightController.h"
+#include "../include/controllers/AdminController.h"
 #include "../include/utils/Logger.h"
+#include "../include/utils/TokenRevocationList.h"
+#include "../include/utils/PasswordHasher.h"
 
 int main() {
     try {
@@ -35,10 +44,59 @@ int main() {
         // Initialize JWT utils with configuration
         JWTUtils::getInstance().setSecret(config.getJwtSecret());
         JWTUtils::getInstance().setExpiresIn(config.getJwtExpiresIn());
+        JWTUtils::getInstance().setCacheSize(static_cast<size_t>(std::max(0, config.getJwtCacheSize())));
+        // Whether a token's user still exists is rechecked at most once per TTL
+        UserStatusCache::getInstance().setTtl(config.getJwtUserCacheTtlMs());
+        UserStatusCache::getInstance().setMaxEntries(static_cast<size_t>(std::max(0, config.getJwtUserCacheSize())));
+        // Logouts and password changes from earlier runs stay in force
+        if (!TokenRevocationList::getInstance().open(config.getJwtRevocationFile())) {
+            LOG_WARNING("Token revocations will not survive a restart");
+        }
         LOG_INFO("JWT utils initialized");
 
+        // Key derivation runs on its own threads; logins beyond the queue get a 429. Every
+        // admitted login waits on its HTTP thread, so hashing threads plus queue may hold at
+        // most half of the HTTP threads and the rest stay free for other requests
+        const int httpThreads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+        const int maxHashCalls = std::max(1, httpThreads / 2);
+        int hashThreads = config.getPasswordHashThreads();
+        int hashQueueSize = std::max(0, config.getPasswordHashQueueSize());
+        if (hashThreads > 0 && hashThreads + hashQueueSize > maxHashCalls) {
+            hashThreads = std::min(hashThreads, maxHashCalls);
+            hashQueueSize = maxHashCalls - hashThreads;
+            LOG_WARNING("password.hashThreads + hashQueueSize exceeds half of the " + std::to_string(httpThreads) +
+                        " HTTP threads; using " + std::to_string(hashThreads) + " threads and a queue of " +
+                        std::to_string(hashQueueSize));
+        }
+        PasswordHasher::getInstance().setIterations(config.getPasswordIterations());
+        PasswordHasher::getInstance().start(hashThreads, hashQueueSize);
+
         LOG_INFO("Initializing database connection pool...");
         auto& dbPool = DBConnectionPool::getInstance();
+        dbPool.setMinPoolSize(config.getDbMinPool());
+        dbPool.setMaxPoolSize(config.getDbMaxPool());
+        dbPool.setIdleTimeout(config.getDbIdleTimeoutMs());
+        dbPool.setWarmupQuorum(config.getDbWarmupQuorum());
+        dbPool.setAcquireTimeout(config.getDbAcquireTimeoutMs());
+        dbPool.setMaxWaiters(config.getDbMaxWaiters());
+        dbPool.setQueuePolicy(config.getDbQueuePolicy());
+        dbPool.setQueueTarget(config.getDbQueueTargetMs());
+        dbPool.setQueueInterval(config.getDbQueueIntervalMs());
+        // The pool size range becomes the range of the adaptive limit; poolSize is where it starts
+        dbPool.setAdaptiveLimit(config.getDbAdaptiveLimit());
+        dbPool.setAdaptiveLimitTolerance(config.getDbAdaptiveLimitTolerance());
+        dbPool.setCircuitBreaker(config.getDbCircuitFailureThreshold(), config.getDbCircuitOpenMs());
+        dbPool.setStatementCacheSize(config.getDbStatementCacheSize());
+        dbPool.setReplicaSelection(config.getDbReplicaSelection());
+        dbPool.setReadYourWritesWindow(config.getDbReadYourWritesMs());
+        // With affinity on, size maxPool for one connection per worker thread plus headroom
+        dbPool.setThreadAffinity(config.getDbThreadAffinity());
+        dbPool.setAffinityIdleTimeout(config.getDbAffinityIdleMs());
+        dbPool.setHealthProbeInterval(config.getDbHealthProbeMs());
+        QueryStats::getInstance().setSlowQueryThreshold(config.getDbSlowQueryMs());
+        // The TTL bounds how long writes made outside this process can go unnoticed
+        QueryCache::getInstance().setMaxBytes(static_cast<size_t>(std::max(0, config.getDbQueryCacheMb())) * 1024 * 1024);
+        QueryCache::getInstance().setTtl(config.getDbQueryCacheTtlMs());
 
         LOG_DEBUG("About to connect to database at " + config.getDbHost() + ":" + std::to_string(config.getDbPort()));
         LOG_DEBUG("Using database: " + config.getDbName() + ", User: " + config.getDbUser());
@@ -47,14 +105,14 @@ int main() {
         bool dbConnected = false;
         try {
             LOG_INFO("Attempting database connection...");
-            // Lower pool size to 1 for initial testing to avoid multiple connection attempts
+            // Connections are opened in parallel; startup continues once the warm-up quorum is connected
             dbConnected = dbPool.initialize(
                 config.getDbHost(),
                 config.getDbUser(),
                 config.getDbPassword(),
                 config.getDbName(),
                 config.getDbPort(),
-                1); // Start with just 1 connection for faster startup
+                config.getDbPoolSize());
 
             LOG_INFO("Database connection attempt completed with result: " +
                     std::string(dbConnected ? "SUCCESS" : "FAILURE"));
@@ -68,11 +126,29 @@ int main() {
             // You could still continue with non-DB endpoints
         } else {
             LOG_INFO("Database connection pool initialized successfully.");
+
+            // Reads are spread over the replicas; a failed replica just leaves reads on the primary
+            for (const auto& replica : config.getDbReplicas()) {
+                LOG_INFO("Connecting to read replica " + replica.host + ":" + std::to_string(replica.port));
+                dbPool.addReplica(
+                    replica.host,
+                    replica.user,
+                    replica.password,
+                    replica.name,
+                    replica.port,
+                    config.getDbPoolSize());
+            }
         }
 
+        // Queries run by the async handlers are capped at executorThreads in flight
+        DBExecutor::getInstance().start(config.getDbExecutorThreads(), config.getDbExecutorQueueSize());
+
         // Create and configure Crow application with middlewares
         LOG_INFO("Creating Crow application...");
-        crow::App<crow::CORSHandler, AuthMiddleware> app;
+        crow::App<crow::CORSHandler, LoadShedMiddleware, AuthMiddleware> app;
+
+        // Route handlers read the token verified by AuthMiddleware instead of verifying it again
+        AuthMiddleware::bind(app);
 
         // Configure CORS
         auto& cors = app.get_middleware<crow::CORSHandler>();
@@ -102,6 +178,99 @@ int main() {
                 return response;
             });
 
+        // Query statistics - admin only
+        CROW_ROUTE(app, "/api/admin/query-stats")
+            .methods("GET"_method)
+            ([](const crow::request& req) {
+                LOG_INFO("Request: GET /api/admin/query-stats");
+
+                if (!is_authenticated(req)) {
+                    return auth_error(401, "Not authorized to access this route");
+                }
+
+                if (!has_role(req, {"admin"})) {
+                    return auth_error(403, "Not authorized to access query statistics");
+                }
+
+                auto response = AdminController::getQueryStats(req);
+                LOG_INFO("Response: " + std::to_string(response.code) + " GET /api/admin/query-stats");
+                return response;
+            });
+
+        CROW_ROUTE(app, "/api/admin/query-stats")
+            .methods("DELETE"_method)
+            ([](const crow::request& req) {
+                LOG_INFO("Request: DELETE /api/admin/query-stats");
+
+                if (!is_authenticated(req)) {
+                    return auth_error(401, "Not authorized to access this route");
+                }
+
+                if (!has_role(req, {"admin"})) {
+                    return auth_error(403, "Not authorized to reset query statistics");
+                }
+
+                auto response = AdminController::resetQueryStats(req);
+                LOG_INFO("Response: " + std::to_string(response.code) + " DELETE /api/admin/query-stats");
+                return response;
+            });
+
+        // Query result cache - admin only
+        CROW_ROUTE(app, "/api/admin/query-cache")
+            .methods("GET"_method)
+            ([](const crow::request& req) {
+                LOG_INFO("Request: GET /api/admin/query-cache");
+
+                if (!is_authenticated(req)) {
+                    return auth_error(401, "Not authorized to access this route");
+                }
+
+                if (!has_role(req, {"admin"})) {
+                    return auth_error(403, "Not authorized to access the query cache");
+                }
+
+                auto response = AdminController::getQueryCacheStats(req);
+                LOG_INFO("Response: " + std::to_string(response.code) + " GET /api/admin/query-cache");
+                return response;
+            });
+
+        CROW_ROUTE(app, "/api/admin/query-cache")
+            .methods("DELETE"_method)
+            ([](const crow::request& req) {
+                LOG_INFO("Request: DELETE /api/admin/query-cache");
+
+                if (!is_authenticated(req)) {
+                    return auth_error(401, "Not authorized to access this route");
+                }
+
+                if (!has_role(req, {"admin"})) {
+                    return auth_error(403, "Not authorized to clear the query cache");
+                }
+
+                auto response = AdminController::clearQueryCache(req);
+                LOG_INFO("Response: " + std::to_string(response.code) + " DELETE /api/admin/query-cache");
+                return response;
+            });
+
+        // Verified-token cache - admin only
+        CROW_ROUTE(app, "/api/admin/token-cache")
+            .methods("GET"_method)
+            ([](const crow::request& req) {
+                LOG_INFO("Request: GET /api/admin/token-cache");
+
+                if (!is_authenticated(req)) {
+                    return auth_error(401, "Not authorized to access this route");
+                }
+
+                if (!has_role(req, {"admin"})) {
+                    return auth_error(403, "Not authorized to access the token cache");
+                }
+
+                auto response = AdminController::getTokenCacheStats(req);
+                LOG_INFO("Response: " + std::to_string(response.code) + " GET /api/admin/token-cache");
+                return response;
+            });
+
         // Auth routes
 
         CROW_ROUTE(app, "/api/auth/register")
@@ -314,6 +483,20 @@ int main() {
                     return response;
                 });
 
+            CROW_ROUTE(app, "/api/crew-members/bulk")
+                .methods("POST"_method)
+                ([](const crow::request& req) {
+                    LOG_INFO("Request: POST /api/crew-members/bulk");
+
+                    if (!has_role(req, {"admin"})) {
+                        return auth_error(403, "Not authorized to create crew members");
+                    }
+
+                    auto response = CrewMemberController::createCrewMembersBulk(req);
+                    LOG_INFO("Response: " + std::to_string(response.code) + " POST /api/crew-members/bulk");
+                    return response;
+                });
+
             CROW_ROUTE(app, "/api/crew-members/<int>")
                 .methods("GET"_method)
                 ([](const crow::request& req, int id) {
@@ -511,6 +694,20 @@ int main() {
                     return response;
                 });
 
+            CROW_ROUTE(app, "/api/crews/<int>/members/bulk")
+                .methods("POST"_method)
+                ([](const crow::request& req, int id) {
+                    LOG_INFO("Request: POST /api/crews/" + std::to_string(id) + "/members/bulk");
+
+                    if (!has_role(req, {"admin"})) {
+                        return auth_error(403, "Not authorized to assign crew members");
+                    }
+
+                    auto response = CrewController::assignCrewMembersBulk(req);
+                    LOG_INFO("Response: " + std::to_string(response.code) + " POST /api/crews/" + std::to_string(id) + "/members/bulk");
+                    return response;
+                });
+
             CROW_ROUTE(app, "/api/crews/<int>/members/<int>")
                 .methods("DELETE"_method)
                 ([](const crow::request& req, int id, int memberId) {
@@ -577,11 +774,14 @@ int main() {
 
         // Use a more basic approach to start the server
         app.port(port);
-        app.multithreaded();
+        // The same thread count the hasher limit above was sized against
+        app.concurrency(static_cast<std::uint16_t>(httpThreads));
         LOG_INFO("Server configured, about to run...");
         app.run();
 
         // This line will never be reached while the server is running
+        DBExecutor::getInstance().stop();
+        PasswordHasher::getInstance().stop();
         LOG_INFO("Server stopped");
     }
     catch (std::exception& e) {
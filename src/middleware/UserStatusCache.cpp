@@ -0,0 +1,94 @@
+#include "../../include/middleware/UserStatusCache.h"
+#include "../../include/database/DBConnectionPool.h"
+
+UserStatusCache::Status UserStatusCache::get(int userId) {
+    Shard& shard = shardFor(userId);
+    auto now = std::chrono::steady_clock::now();
+    bool enabled = ttl.count() > 0 && maxEntries.load(std::memory_order_relaxed) > 0;
+
+    if (enabled) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.entries.find(userId);
+        if (it != shard.entries.end() && now < it->second.expires) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.status;
+        }
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+    uint64_t fetchGeneration = generation.load(std::memory_order_acquire);
+    Status status = fetch(userId);
+
+    if (!enabled) {
+        return status;
+    }
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // An invalidate() ran while fetching; what was read may predate it
+    if (fetchGeneration != generation.load(std::memory_order_acquire)) {
+        return status;
+    }
+
+    size_t maxPerShard = (maxEntries.load(std::memory_order_relaxed) + kShards - 1) / kShards;
+    if (shard.entries.size() >= maxPerShard && !shard.entries.count(userId)) {
+        // Make room from expired entries first, then from anywhere
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            it = now >= it->second.expires ? shard.entries.erase(it) : std::next(it);
+        }
+        if (shard.entries.size() >= maxPerShard) {
+            shard.entries.erase(shard.entries.begin());
+        }
+    }
+
+    shard.entries[userId] = {status, now + ttl};
+    return status;
+}
+
+void UserStatusCache::invalidate(int userId) {
+    Shard& shard = shardFor(userId);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    shard.entries.erase(userId);
+    invalidations.fetch_add(1, std::memory_order_relaxed);
+}
+
+UserStatusCache::Stats UserStatusCache::getStats() {
+    Stats stats{};
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    stats.invalidations = invalidations.load(std::memory_order_relaxed);
+
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.entries += shard.entries.size();
+    }
+
+    return stats;
+}
+
+void UserStatusCache::clear() {
+    generation.fetch_add(1, std::memory_order_acq_rel);
+
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+    }
+}
+
+UserStatusCache::Status UserStatusCache::fetch(int userId) {
+    // From the primary: a replica may not have the row of a user who just registered yet, and
+    // a "no such user" read from it would be cached as a 401 for the whole TTL
+    auto db = DBConnectionPool::getInstance().getConnection();
+    auto stmt = db->prepareStatement("SELECT role FROM users WHERE user_id = ?");
+    stmt->setInt(1, userId);
+    auto result = db->executeQuery(stmt);
+
+    if (!result->next()) {
+        return {false, ""};
+    }
+
+    return {true, std::string(result->getString("role").c_str())};
+}
@@ -1,9 +1,13 @@
 #include "../../include/utils/JWTUtils.h"
 #include "../../include/utils/Logger.h"
+#include "../../include/utils/TokenRevocationList.h"
 #include <jwt-cpp/jwt.h>
+#include <openssl/rand.h>
 #include <chrono>
 #include <stdexcept>
 #include <sstream>
+#include <functional>
+#include <cstdlib>
 
 std::string JWTUtils::generateToken(int userId, const std::string& role) {
     try {
@@ -13,6 +17,7 @@ std::string JWTUtils::generateToken(int userId, const std::string& role) {
         // Create JWT token
         auto token = jwt::create()
             .set_issuer("airline-api")
+            .set_id(newTokenId())
             .set_issued_at(now)
             .set_expires_at(now + std::chrono::seconds(expiresIn))
             .set_payload_claim("id", jwt::claim(std::to_string(userId)))
@@ -27,6 +32,80 @@ std::string JWTUtils::generateToken(int userId, const std::string& role) {
 }
 
 bool JWTUtils::verifyToken(const std::string& token, std::unordered_map<std::string, std::string>& payload) {
+    size_t digest = std::hash<std::string>{}(token);
+    CacheShard& shard = cacheShards[digest % kCacheShards];
+    auto now = std::chrono::system_clock::now();
+
+    if (cacheSize.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(digest);
+        if (it != shard.index.end() && it->second->token == token) {
+            if (now < it->second->expiresAt) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                payload = it->second->payload;
+                cacheHits.fetch_add(1, std::memory_order_relaxed);
+
+                // Revocation is checked on every use, so revoking never has to touch the cache
+                return !isRevoked(payload, it->second->issuedAt);
+            }
+
+            // Expired since it was cached; the full check below rejects it
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+            cacheExpired.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    cacheMisses.fetch_add(1, std::memory_order_relaxed);
+    uint64_t generation = cacheGeneration.load(std::memory_order_acquire);
+
+    auto started = std::chrono::steady_clock::now();
+    std::chrono::system_clock::time_point expiresAt;
+    std::chrono::system_clock::time_point issuedAt;
+    bool valid = verifyUncached(token, payload, expiresAt, issuedAt);
+    verifyUs.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count(), std::memory_order_relaxed);
+
+    // Revocation decides the answer on every path, whether or not the result is cached below
+    bool accepted = valid && !isRevoked(payload, issuedAt);
+
+    // Only successful verifications are kept, and only those with an expiry to drop them at
+    size_t maxEntries = cacheSize.load(std::memory_order_relaxed);
+    if (!valid || maxEntries == 0 || expiresAt <= now) {
+        return accepted;
+    }
+
+    size_t maxPerShard = (maxEntries + kCacheShards - 1) / kCacheShards;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // The secret changed while verifying; the result may no longer hold
+    if (generation != cacheGeneration.load(std::memory_order_acquire)) {
+        return accepted;
+    }
+
+    auto it = shard.index.find(digest);
+    if (it != shard.index.end()) {
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+
+    shard.lru.push_front({token, payload, expiresAt, issuedAt});
+    shard.index[digest] = shard.lru.begin();
+
+    while (shard.lru.size() > maxPerShard) {
+        shard.index.erase(std::hash<std::string>{}(shard.lru.back().token));
+        shard.lru.pop_back();
+        cacheEvictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return accepted;
+}
+
+bool JWTUtils::verifyUncached(const std::string& token, std::unordered_map<std::string, std::string>& payload,
+                              std::chrono::system_clock::time_point& expiresAt,
+                              std::chrono::system_clock::time_point& issuedAt) {
     try {
         // Verify and decode token
         auto decoded = jwt::decode(token);
@@ -42,6 +121,18 @@ bool JWTUtils::verifyToken(const std::string& token, std::unordered_map<std::str
         payload["id"] = decoded.get_payload_claim("id").as_string();
         payload["role"] = decoded.get_payload_claim("role").as_string();
 
+        expiresAt = decoded.has_expires_at() ? decoded.get_expires_at() : std::chrono::system_clock::time_point();
+        issuedAt = decoded.has_issued_at() ? decoded.get_issued_at() : std::chrono::system_clock::time_point();
+
+        // Logout needs these to revoke the token until it expires
+        if (decoded.has_id()) {
+            payload["jti"] = decoded.get_id();
+        }
+        if (decoded.has_expires_at()) {
+            payload["exp"] = std::to_string(
+                std::chrono::duration_cast<std::chrono::seconds>(expiresAt.time_since_epoch()).count());
+        }
+
         return true;
     } catch (const jwt::error::token_verification_exception& e) {
         LOG_ERROR("JWT token verification failed: " + std::string(e.what()));
@@ -51,3 +142,69 @@ bool JWTUtils::verifyToken(const std::string& token, std::unordered_map<std::str
         return false;
     }
 }
+
+bool JWTUtils::isRevoked(const std::unordered_map<std::string, std::string>& payload,
+                         std::chrono::system_clock::time_point issuedAt) {
+    auto id = payload.find("id");
+    auto jti = payload.find("jti");
+
+    bool revoked = TokenRevocationList::getInstance().isRevoked(
+        jti != payload.end() ? jti->second : std::string(),
+        id != payload.end() ? std::atoi(id->second.c_str()) : 0,
+        issuedAt);
+
+    if (revoked) {
+        LOG_DEBUG("Rejected revoked JWT token");
+    }
+    return revoked;
+}
+
+std::string JWTUtils::newTokenId() {
+    static const char* hexDigits = "0123456789abcdef";
+    unsigned char bytes[16];
+
+    if (RAND_bytes(bytes, sizeof(bytes)) != 1) {
+        throw std::runtime_error("Could not generate a token id");
+    }
+
+    std::string id;
+    id.reserve(sizeof(bytes) * 2);
+    for (unsigned char byte : bytes) {
+        id += hexDigits[byte >> 4];
+        id += hexDigits[byte & 0x0F];
+    }
+    return id;
+}
+
+void JWTUtils::setSecret(const std::string& secret) {
+    this->secret = secret;
+    clearCache();
+}
+
+void JWTUtils::clearCache() {
+    cacheGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+    for (auto& shard : cacheShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.lru.clear();
+        shard.index.clear();
+    }
+}
+
+JWTUtils::CacheStats JWTUtils::getCacheStats() {
+    CacheStats stats{};
+    stats.hits = cacheHits.load(std::memory_order_relaxed);
+    stats.misses = cacheMisses.load(std::memory_order_relaxed);
+    stats.expired = cacheExpired.load(std::memory_order_relaxed);
+    stats.evictions = cacheEvictions.load(std::memory_order_relaxed);
+    stats.maxEntries = cacheSize.load(std::memory_order_relaxed);
+    stats.verifyUs = verifyUs.load(std::memory_order_relaxed);
+    stats.savedUs = stats.misses > 0 ? stats.verifyUs * stats.hits / stats.misses : 0;
+
+    for (auto& shard : cacheShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.entries += shard.lru.size();
+    }
+
+    return stats;
+}
@@ -0,0 +1,232 @@
+#include "../../include/utils/JsonStreamWriter.h"
+#include <charconv>
+#include <cmath>
+
+JsonStreamWriter::JsonStreamWriter(std::string& out, int indent)
+    : out(out), indent(indent), afterKey(false) {}
+
+void JsonStreamWriter::beginObject() {
+    prefix();
+    out += '{';
+    scopes.push_back({false, 0});
+}
+
+void JsonStreamWriter::endObject() {
+    bool empty = scopes.back().count == 0;
+    scopes.pop_back();
+    if (!empty) {
+        newline();
+    }
+    out += '}';
+}
+
+void JsonStreamWriter::beginArray() {
+    prefix();
+    out += '[';
+    scopes.push_back({true, 0});
+}
+
+void JsonStreamWriter::endArray() {
+    bool empty = scopes.back().count == 0;
+    scopes.pop_back();
+    if (!empty) {
+        newline();
+    }
+    out += ']';
+}
+
+void JsonStreamWriter::key(const std::string& name) {
+    auto& scope = scopes.back();
+    if (scope.count++ > 0) {
+        out += ',';
+    }
+    newline();
+    writeString(name);
+    out += ": ";
+    afterKey = true;
+}
+
+void JsonStreamWriter::value(int64_t number) {
+    prefix();
+    out += std::to_string(number);
+}
+
+void JsonStreamWriter::value(double number) {
+    prefix();
+
+    // JSON has no NaN or infinity; json::dump writes null for them too
+    if (!std::isfinite(number)) {
+        out += "null";
+        return;
+    }
+
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    std::string text(buffer, end);
+
+    // Keep whole numbers recognisable as floating point, as json::dump does
+    if (text.find_first_of(".eE") == std::string::npos) {
+        text += ".0";
+    }
+    out += text;
+}
+
+void JsonStreamWriter::value(bool flag) {
+    prefix();
+    out += flag ? "true" : "false";
+}
+
+void JsonStreamWriter::value(const std::string& text) {
+    prefix();
+    writeString(text);
+}
+
+void JsonStreamWriter::null() {
+    prefix();
+    out += "null";
+}
+
+size_t JsonStreamWriter::writeRows(sql::ResultSet& result, const std::vector<Column>& columns, size_t maxRows) {
+    // Look the columns up once instead of by name for every row
+    std::vector<int32_t> indexes;
+    size_t rows = 0;
+
+    while (rows < maxRows && result.next()) {
+        if (indexes.empty()) {
+            for (const auto& column : columns) {
+                indexes.push_back(result.findColumn(column.name));
+            }
+        }
+
+        beginObject();
+        for (size_t i = 0; i < columns.size(); ++i) {
+            key(columns[i].name);
+
+            int32_t index = indexes[i];
+            if (result.isNull(index)) {
+                null();
+                continue;
+            }
+
+            switch (columns[i].type) {
+                case ColumnType::Int:
+                    value(static_cast<int64_t>(result.getLong(index)));
+                    break;
+                case ColumnType::Double:
+                    value(result.getDouble(index));
+                    break;
+                case ColumnType::String:
+                    value(std::string(result.getString(index).c_str()));
+                    break;
+            }
+        }
+        endObject();
+        rows++;
+    }
+
+    return rows;
+}
+
+void JsonStreamWriter::prefix() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+
+    if (scopes.empty()) {
+        return;
+    }
+
+    auto& scope = scopes.back();
+    if (scope.count++ > 0) {
+        out += ',';
+    }
+    newline();
+}
+
+void JsonStreamWriter::newline() {
+    out += '\n';
+    out.append(scopes.size() * indent, ' ');
+}
+
+namespace {
+    // Length of the well-formed UTF-8 sequence starting at text[i], or 0 when it is not one.
+    // *valid is set to how many of its bytes were valid before it broke off (at least 1).
+    size_t utf8SequenceLength(const std::string& text, size_t i, size_t* valid) {
+        auto byte = [&](size_t k) { return static_cast<unsigned char>(text[k]); };
+        unsigned char lead = byte(i);
+        *valid = 1;
+
+        size_t length;
+        unsigned char low = 0x80, high = 0xBF; // allowed range of the second byte
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            if (lead == 0xE0) low = 0xA0;       // overlong
+            if (lead == 0xED) high = 0x9F;      // surrogates
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            if (lead == 0xF0) low = 0x90;       // overlong
+            if (lead == 0xF4) high = 0x8F;      // above U+10FFFF
+        } else {
+            return 0;
+        }
+
+        for (size_t k = 1; k < length; ++k) {
+            if (i + k >= text.size()) {
+                return 0;
+            }
+            unsigned char c = byte(i + k);
+            if (k == 1 ? (c < low || c > high) : (c < 0x80 || c > 0xBF)) {
+                return 0;
+            }
+            *valid = k + 1;
+        }
+        return length;
+    }
+}
+
+void JsonStreamWriter::writeString(const std::string& text) {
+    static const char* hexDigits = "0123456789abcdef";
+
+    out += '"';
+    for (size_t i = 0; i < text.size();) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+
+        if (c >= 0x80) {
+            // Invalid UTF-8 would make the whole body unparseable; like json::dump with
+            // error_handler_t::replace, each broken sequence becomes one U+FFFD
+            size_t valid;
+            size_t length = utf8SequenceLength(text, i, &valid);
+            if (length > 0) {
+                out.append(text, i, length);
+                i += length;
+            } else {
+                out += "\xEF\xBF\xBD";
+                i += valid;
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    out += "\\u00";
+                    out += hexDigits[c >> 4];
+                    out += hexDigits[c & 0x0F];
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+        ++i;
+    }
+    out += '"';
+}
@@ -0,0 +1,241 @@
+#include "../../include/utils/PasswordHasher.h"
+#include "../../include/utils/Logger.h"
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    const std::string kPrefix = "pbkdf2_sha256$";
+    constexpr size_t kSaltBytes = 16;
+    constexpr size_t kHashBytes = 32;
+    constexpr int kMaxIterations = 10000000;
+
+    std::string toHex(const unsigned char* bytes, size_t length) {
+        static const char* hexDigits = "0123456789abcdef";
+        std::string out;
+        out.reserve(length * 2);
+        for (size_t i = 0; i < length; ++i) {
+            out += hexDigits[bytes[i] >> 4];
+            out += hexDigits[bytes[i] & 0x0F];
+        }
+        return out;
+    }
+
+    bool fromHex(const std::string& text, std::vector<unsigned char>& out) {
+        if (text.size() % 2 != 0) {
+            return false;
+        }
+
+        auto nibble = [](char c) -> int {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        };
+
+        out.clear();
+        out.reserve(text.size() / 2);
+        for (size_t i = 0; i < text.size(); i += 2) {
+            int high = nibble(text[i]);
+            int low = nibble(text[i + 1]);
+            if (high < 0 || low < 0) {
+                return false;
+            }
+            out.push_back(static_cast<unsigned char>(high << 4 | low));
+        }
+        return true;
+    }
+
+    bool derive(const std::string& password, const unsigned char* salt, size_t saltLength, int iterations,
+                unsigned char* out, size_t outLength) {
+        return PKCS5_PBKDF2_HMAC(password.data(), static_cast<int>(password.size()),
+                                 salt, static_cast<int>(saltLength), iterations, EVP_sha256(),
+                                 static_cast<int>(outLength), out) == 1;
+    }
+}
+
+PasswordHasher::~PasswordHasher() {
+    stop();
+}
+
+void PasswordHasher::start(int threads, int maxQueued) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (running) {
+        LOG_WARNING("Password hasher already started");
+        return;
+    }
+
+    if (threads <= 0) {
+        LOG_INFO("Password hasher pool disabled; hashing runs on the request threads");
+        return;
+    }
+
+    this->maxQueued = static_cast<size_t>(std::max(0, maxQueued));
+    running = true;
+
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&PasswordHasher::workerLoop, this);
+    }
+
+    LOG_INFO("Password hasher started with " + std::to_string(threads) +
+             " threads and a queue of " + std::to_string(this->maxQueued));
+}
+
+void PasswordHasher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+
+    jobAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+
+    LOG_INFO("Password hasher stopped");
+}
+
+std::string PasswordHasher::hash(const std::string& password) {
+    return run([this, password]() { return hashNow(password); });
+}
+
+PasswordHasher::Verification PasswordHasher::verify(const std::string& password, const std::string& stored) {
+    // Legacy plaintext values cost nothing to compare, so they skip the queue
+    if (stored.compare(0, kPrefix.size(), kPrefix) != 0) {
+        return verifyNow(password, stored);
+    }
+
+    return run([this, password, stored]() { return verifyNow(password, stored); });
+}
+
+std::string PasswordHasher::hashNow(const std::string& password) {
+    int rounds = iterations.load(std::memory_order_relaxed);
+    unsigned char salt[kSaltBytes];
+    unsigned char derived[kHashBytes];
+
+    if (RAND_bytes(salt, sizeof(salt)) != 1 || !derive(password, salt, sizeof(salt), rounds, derived, sizeof(derived))) {
+        throw std::runtime_error("Could not hash password");
+    }
+
+    return kPrefix + std::to_string(rounds) + "$" + toHex(salt, sizeof(salt)) + "$" + toHex(derived, sizeof(derived));
+}
+
+PasswordHasher::Verification PasswordHasher::verifyNow(const std::string& password, const std::string& stored) {
+    if (stored.compare(0, kPrefix.size(), kPrefix) != 0) {
+        // Constant-time for equal lengths; the length itself is not worth hiding for a value being replaced
+        bool valid = password.size() == stored.size() && CRYPTO_memcmp(password.data(), stored.data(), stored.size()) == 0;
+        return {valid, true};
+    }
+
+    // pbkdf2_sha256$<iterations>$<salt>$<hash>
+    size_t saltStart = stored.find('$', kPrefix.size());
+    size_t hashStart = saltStart == std::string::npos ? std::string::npos : stored.find('$', saltStart + 1);
+    if (hashStart == std::string::npos) {
+        LOG_ERROR("Malformed password hash");
+        return {false, false};
+    }
+
+    int rounds = std::atoi(stored.substr(kPrefix.size(), saltStart - kPrefix.size()).c_str());
+    std::vector<unsigned char> salt;
+    std::vector<unsigned char> expected;
+
+    if (rounds <= 0 || rounds > kMaxIterations ||
+        !fromHex(stored.substr(saltStart + 1, hashStart - saltStart - 1), salt) ||
+        !fromHex(stored.substr(hashStart + 1), expected) || expected.empty()) {
+        LOG_ERROR("Malformed password hash");
+        return {false, false};
+    }
+
+    std::vector<unsigned char> derived(expected.size());
+    if (!derive(password, salt.data(), salt.size(), rounds, derived.data(), derived.size())) {
+        throw std::runtime_error("Could not verify password");
+    }
+
+    bool valid = CRYPTO_memcmp(derived.data(), expected.data(), expected.size()) == 0;
+    return {valid, valid && rounds < iterations.load(std::memory_order_relaxed)};
+}
+
+bool PasswordHasher::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!running) {
+            return false;
+        }
+
+        // Every admitted call holds an HTTP thread until its hash is done, running or not
+        if (jobs.size() + static_cast<size_t>(active) >= workers.size() + maxQueued) {
+            rejected++;
+            throw PasswordHasherBusyError("Password hashing queue is full");
+        }
+
+        jobs.push_back(std::move(job));
+        queued++;
+    }
+
+    jobAvailable.notify_one();
+    return true;
+}
+
+bool PasswordHasher::runWhenIdle(std::function<void()> job) {
+    bool pooled = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (running) {
+            if (jobs.size() + static_cast<size_t>(active) >= workers.size()) {
+                return false;
+            }
+
+            jobs.push_back(std::move(job));
+            queued++;
+            pooled = true;
+        }
+    }
+
+    if (pooled) {
+        jobAvailable.notify_one();
+    } else {
+        job();
+    }
+    return true;
+}
+
+void PasswordHasher::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return !running || !jobs.empty(); });
+
+            // Drain what is already queued before exiting so no caller is left waiting
+            if (jobs.empty()) {
+                return;
+            }
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            queued--;
+            active++;
+        }
+
+        // packaged_task stores any exception in the future, and runWhenIdle jobs catch their
+        // own, so job() does not throw
+        job();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        active--;
+    }
+}
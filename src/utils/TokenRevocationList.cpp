@@ -0,0 +1,221 @@
+#include "../../include/utils/TokenRevocationList.h"
+#include "../../include/utils/Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+TokenRevocationList::TokenRevocationList()
+    : wheelTick(toSeconds(Clock::now()) / kTick.count()), dropped(0) {}
+
+bool TokenRevocationList::open(const std::string& path) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    this->path = path;
+
+    if (path.empty()) {
+        return true;
+    }
+
+    // One revocation per line: "t <jti> <exp>" or "u <user id> <revoked before> <until>", in epoch seconds
+    auto now = Clock::now();
+    size_t loaded = 0;
+    std::ifstream in(path);
+    std::string line;
+
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+
+        if (kind == "t") {
+            std::string tokenId;
+            int64_t expiresAt = 0;
+            if (fields >> tokenId >> expiresAt && addToken(tokenId, fromSeconds(expiresAt), now)) {
+                loaded++;
+            }
+        } else if (kind == "u") {
+            int userId = 0;
+            int64_t revokedBefore = 0;
+            int64_t until = 0;
+            if (fields >> userId >> revokedBefore >> until &&
+                addUser(userId, {fromSeconds(revokedBefore), fromSeconds(until)}, now)) {
+                loaded++;
+            }
+        }
+    }
+    in.close();
+
+    // Start from a compacted file without the entries that expired while we were down
+    rewriteFile();
+
+    if (!file.is_open()) {
+        LOG_ERROR("Could not open token revocation file " + path);
+        return false;
+    }
+
+    LOG_INFO("Loaded " + std::to_string(loaded) + " token revocations from " + path);
+    return true;
+}
+
+void TokenRevocationList::revokeToken(const std::string& tokenId, Clock::time_point expiresAt) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto now = Clock::now();
+
+    if (advance(now) > 0) {
+        rewriteFile();
+    }
+
+    if (addToken(tokenId, expiresAt, now) && file.is_open()) {
+        file << "t " << tokenId << ' ' << toSeconds(expiresAt) << '\n' << std::flush;
+    }
+}
+
+void TokenRevocationList::revokeUser(int userId, Clock::time_point until) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto now = Clock::now();
+
+    if (advance(now) > 0) {
+        rewriteFile();
+    }
+
+    // Token times have whole-second resolution; a token issued in this second stays valid,
+    // so one issued right after revoking (e.g. on password change) is not caught
+    UserEpoch epoch{fromSeconds(toSeconds(now)), until};
+    if (addUser(userId, epoch, now) && file.is_open()) {
+        file << "u " << userId << ' ' << toSeconds(epoch.revokedBefore) << ' ' << toSeconds(until) << '\n' << std::flush;
+    }
+}
+
+bool TokenRevocationList::isRevoked(const std::string& tokenId, int userId, Clock::time_point issuedAt) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    if (!tokenId.empty() && tokens.count(tokenId)) {
+        return true;
+    }
+
+    auto it = users.find(userId);
+    return it != users.end() && issuedAt < it->second.revokedBefore;
+}
+
+TokenRevocationList::Stats TokenRevocationList::getStats() {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return {tokens.size(), users.size(), dropped};
+}
+
+bool TokenRevocationList::addToken(const std::string& tokenId, Clock::time_point expiresAt, Clock::time_point now) {
+    if (tokenId.empty() || expiresAt <= now) {
+        return false;
+    }
+
+    auto [it, inserted] = tokens.emplace(tokenId, expiresAt);
+    if (!inserted) {
+        return false;
+    }
+
+    schedule({tokenId, 0, expiresAt});
+    return true;
+}
+
+bool TokenRevocationList::addUser(int userId, UserEpoch epoch, Clock::time_point now) {
+    if (epoch.until <= now) {
+        return false;
+    }
+
+    auto it = users.find(userId);
+    if (it != users.end()) {
+        // Keep the later cut-off and whichever of the two covers tokens for longer
+        epoch.revokedBefore = std::max(epoch.revokedBefore, it->second.revokedBefore);
+        epoch.until = std::max(epoch.until, it->second.until);
+    }
+
+    users[userId] = epoch;
+    schedule({"", userId, epoch.until});
+    return true;
+}
+
+void TokenRevocationList::schedule(Timer timer) {
+    // A slot the wheel has already passed would not come round again for a whole turn
+    int64_t tick = std::max(toSeconds(timer.expiresAt) / kTick.count(), wheelTick + 1);
+    wheel[static_cast<size_t>(tick) % kWheelSlots].push_back(std::move(timer));
+}
+
+size_t TokenRevocationList::advance(Clock::time_point now) {
+    int64_t nowTick = toSeconds(now) / kTick.count();
+    if (nowTick <= wheelTick) {
+        return 0;
+    }
+
+    // Visit each slot whose tick has come, at most once around the wheel
+    int64_t first = std::max(wheelTick + 1, nowTick - static_cast<int64_t>(kWheelSlots) + 1);
+    size_t removed = 0;
+
+    for (int64_t tick = first; tick <= nowTick; ++tick) {
+        auto& slot = wheel[static_cast<size_t>(tick) % kWheelSlots];
+
+        for (size_t i = 0; i < slot.size();) {
+            Timer& timer = slot[i];
+            if (timer.expiresAt > now) {
+                ++i;
+                continue;
+            }
+
+            // A later revocation may have extended the entry; only drop what this timer was for
+            if (timer.tokenId.empty()) {
+                auto it = users.find(timer.userId);
+                if (it != users.end() && it->second.until <= now) {
+                    users.erase(it);
+                    removed++;
+                }
+            } else {
+                auto it = tokens.find(timer.tokenId);
+                if (it != tokens.end() && it->second <= now) {
+                    tokens.erase(it);
+                    removed++;
+                }
+            }
+
+            std::swap(timer, slot.back());
+            slot.pop_back();
+        }
+    }
+
+    wheelTick = nowTick;
+    dropped += removed;
+    return removed;
+}
+
+void TokenRevocationList::rewriteFile() {
+    if (path.empty()) {
+        return;
+    }
+
+    // Write the live entries to a new file and swap it in, so a crash leaves one of the two intact
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        for (const auto& [tokenId, expiresAt] : tokens) {
+            out << "t " << tokenId << ' ' << toSeconds(expiresAt) << '\n';
+        }
+        for (const auto& [userId, epoch] : users) {
+            out << "u " << userId << ' ' << toSeconds(epoch.revokedBefore) << ' ' << toSeconds(epoch.until) << '\n';
+        }
+
+        if (!out) {
+            LOG_ERROR("Could not write token revocation file " + temporary);
+            return;
+        }
+    }
+
+    file.close();
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("Could not replace token revocation file " + path);
+    }
+    file.open(path, std::ios::app);
+}
+
+int64_t TokenRevocationList::toSeconds(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+TokenRevocationList::Clock::time_point TokenRevocationList::fromSeconds(int64_t seconds) {
+    return Clock::time_point(std::chrono::seconds(seconds));
+}